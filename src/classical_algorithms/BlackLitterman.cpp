@@ -0,0 +1,122 @@
+#include "BlackLitterman.hpp"
+#include "../utils/Instrumentation.hpp"
+#include "../utils/LinearAlgebra.hpp"
+#include <stdexcept>
+
+BlackLitterman::BlackLitterman(FactorizationCache& cache, double tau, double riskAversion)
+    : cache(cache), tau(tau), risk_aversion(riskAversion) {
+    if (!(tau > 0.0) || !(riskAversion > 0.0)) {
+        throw std::invalid_argument("Tau and risk aversion must be positive.");
+    }
+}
+
+std::vector<double> BlackLitterman::impliedReturns(const std::vector<double>& marketWeights) const {
+    const auto state = cache.snapshot();
+    const std::size_t n = state->dimension;
+    if (marketWeights.size() != n) {
+        throw std::invalid_argument("Market weights must have one entry per asset.");
+    }
+    std::vector<double> implied(n);
+    LinearAlgebra::gemm(n, 1, n, state->covariance.data(), n, marketWeights.data(), 1, implied.data(), 1, false, 0);
+    for (double& value : implied) value *= risk_aversion;
+    return implied;
+}
+
+BlackLitterman::Result BlackLitterman::posterior(const std::vector<double>& priorReturns, const Views& views,
+                                                 bool computeCovariance) const {
+    QPO_SCOPED_TIMER("BlackLitterman::posterior");
+    // One snapshot for the whole posterior, so Sigma and its factor belong to the same covariance version
+    const auto state = cache.snapshot(true);
+    const std::size_t n = state->dimension;
+    const std::size_t k = views.pick.size1();
+    if (priorReturns.size() != n || (k > 0 && views.pick.size2() != n)) {
+        throw std::invalid_argument("Prior returns and pick matrix must have one column per asset.");
+    }
+    if (views.returns.size() != k || (!views.variances.empty() && views.variances.size() != k)) {
+        throw std::invalid_argument("View returns and variances must have one entry per view.");
+    }
+    const std::vector<double>& sigma = state->covariance;
+    const double* pick = k > 0 ? &views.pick.data()[0] : nullptr;
+
+    // Sigma P^T (n x k) and G = P Sigma P^T (k x k)
+    std::vector<double> pickTransposed(n * k);
+    for (std::size_t v = 0; v < k; ++v) {
+        for (std::size_t i = 0; i < n; ++i) pickTransposed[i * k + v] = pick[v * n + i];
+    }
+    std::vector<double> sigmaPickT(n * k);
+    std::vector<double> gram(k * k);
+    LinearAlgebra::gemm(n, k, n, sigma.data(), n, pickTransposed.data(), k, sigmaPickT.data(), k, false, 0);
+    LinearAlgebra::gemm(k, k, n, pick, n, sigmaPickT.data(), k, gram.data(), k, false, 1);
+
+    std::vector<double> omega(k);
+    for (std::size_t v = 0; v < k; ++v) {
+        omega[v] = views.variances.empty() ? tau * gram[v * k + v] : views.variances[v];
+        if (!(omega[v] > 0.0)) {
+            throw std::invalid_argument("View variances must be positive.");
+        }
+    }
+
+    // A = tau G + Omega; mu_BL = pi + tau Sigma P^T A^-1 (q - P pi)
+    std::vector<double> factorA(k * k);
+    for (std::size_t i = 0; i < k * k; ++i) factorA[i] = tau * gram[i];
+    for (std::size_t v = 0; v < k; ++v) factorA[v * k + v] += omega[v];
+    if (!LinearAlgebra::cholesky(factorA.data(), k, 1)) {
+        throw std::invalid_argument("View covariance is not positive definite.");
+    }
+    std::vector<double> surprise(k);
+    for (std::size_t v = 0; v < k; ++v) {
+        double implied = 0.0;
+        for (std::size_t i = 0; i < n; ++i) implied += pick[v * n + i] * priorReturns[i];
+        surprise[v] = views.returns[v] - implied;
+    }
+    LinearAlgebra::choleskySolve(factorA.data(), k, surprise.data());
+
+    Result result;
+    result.posteriorReturns = priorReturns;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t v = 0; v < k; ++v) result.posteriorReturns[i] += tau * sigmaPickT[i * k + v] * surprise[v];
+    }
+
+    // Woodbury with Sigma_BL = c Sigma - U A^-1 U^T, U = tau Sigma P^T, c = 1 + tau: since Sigma^-1 U = tau P^T,
+    // Sigma_BL^-1 mu = Sigma^-1 mu / c + (tau / c)^2 P^T M^-1 P mu with M = (tau / c) G + Omega
+    const double c = 1.0 + tau;
+    std::vector<double> factorM(k * k);
+    for (std::size_t i = 0; i < k * k; ++i) factorM[i] = tau / c * gram[i];
+    for (std::size_t v = 0; v < k; ++v) factorM[v * k + v] += omega[v];
+    if (!LinearAlgebra::cholesky(factorM.data(), k, 1)) {
+        throw std::invalid_argument("View covariance is not positive definite.");
+    }
+    std::vector<double> pickedMean(k, 0.0);
+    for (std::size_t v = 0; v < k; ++v) {
+        for (std::size_t i = 0; i < n; ++i) pickedMean[v] += pick[v * n + i] * result.posteriorReturns[i];
+    }
+    LinearAlgebra::choleskySolve(factorM.data(), k, pickedMean.data());
+
+    result.weights = result.posteriorReturns;
+    LinearAlgebra::choleskySolve(state->factor.data(), n, result.weights.data());
+    const double correction = (tau / c) * (tau / c);
+    for (std::size_t i = 0; i < n; ++i) {
+        double lowRank = 0.0;
+        for (std::size_t v = 0; v < k; ++v) lowRank += pickTransposed[i * k + v] * pickedMean[v];
+        result.weights[i] = (result.weights[i] / c + correction * lowRank) / risk_aversion;
+    }
+
+    if (computeCovariance) {
+        // Sigma_BL = c Sigma - tau^2 Y^T Y with Y = L_A^-1 P Sigma (k x n), one triangular solve per asset
+        std::vector<double> solvedT(sigmaPickT);
+        for (std::size_t i = 0; i < n; ++i) LinearAlgebra::solveLower(factorA.data(), k, solvedT.data() + i * k);
+        std::vector<double> solved(k * n);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t v = 0; v < k; ++v) solved[v * n + i] = solvedT[i * k + v];
+        }
+        std::vector<double> lowRank(n * n);
+        LinearAlgebra::gemm(n, n, k, solvedT.data(), k, solved.data(), n, lowRank.data(), n, false, 0);
+        result.posteriorCovariance.resize(n, n);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                result.posteriorCovariance(i, j) = c * sigma[i * n + j] - tau * tau * lowRank[i * n + j];
+            }
+        }
+    }
+    return result;
+}
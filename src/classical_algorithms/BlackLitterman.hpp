@@ -0,0 +1,73 @@
+#pragma once
+
+#ifndef BLACK_LITTERMAN_HPP
+#define BLACK_LITTERMAN_HPP
+
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for the view matrix
+#include "../utils/FactorizationCache.hpp"
+
+/**
+ * @class BlackLitterman
+ * @brief Black-Litterman posterior returns and weights computed with Cholesky solves only.
+ *
+ * For k views P mu = q + e, e ~ N(0, Omega), and prior mu ~ N(pi, tau Sigma), the posterior mean is
+ *     mu_BL = pi + tau Sigma P^T A^-1 (q - P pi),   A = tau P Sigma P^T + Omega   (k x k),
+ * and the posterior covariance of returns is Sigma_BL = (1 + tau) Sigma - tau^2 Sigma P^T A^-1 P Sigma.
+ * Only the small k x k matrix A is factorized per call. The optimal weights (delta Sigma_BL)^-1 mu_BL are
+ * obtained through the Woodbury identity, which reduces them to one solve with the cached Cholesky factor
+ * of Sigma plus another k x k factorization, so changing views never refactorizes the n x n covariance.
+ * No explicit inverse is formed anywhere.
+ */
+class BlackLitterman {
+public:
+    /**
+     * @brief Investor views P mu = q with their uncertainty.
+     */
+    struct Views {
+        boost::numeric::ublas::matrix<double> pick;  ///< k x n pick matrix P.
+        std::vector<double> returns;                 ///< k expected view returns q.
+        std::vector<double> variances;               ///< Diagonal of Omega; empty for Omega = diag(tau P Sigma P^T).
+    };
+
+    /**
+     * @brief Posterior estimates.
+     */
+    struct Result {
+        std::vector<double> posteriorReturns;                    ///< mu_BL.
+        std::vector<double> weights;                             ///< (delta Sigma_BL)^-1 mu_BL.
+        boost::numeric::ublas::matrix<double> posteriorCovariance; ///< Sigma_BL, only if requested.
+    };
+
+    /**
+     * @brief Constructor for the BlackLitterman class.
+     *
+     * @param cache Cache holding the covariance; it must outlive the model.
+     * @param tau Scaling of the prior uncertainty of the mean.
+     * @param riskAversion Risk aversion delta of the representative investor.
+     * @throws std::invalid_argument if tau or the risk aversion is not positive.
+     */
+    BlackLitterman(FactorizationCache& cache, double tau = 0.05, double riskAversion = 2.5);
+
+    /**
+     * @brief Equilibrium returns implied by market weights, pi = delta Sigma w_mkt.
+     */
+    std::vector<double> impliedReturns(const std::vector<double>& marketWeights) const;
+
+    /**
+     * @brief Combines the prior returns with the views.
+     *
+     * @param priorReturns Equilibrium returns pi.
+     * @param views Pick matrix, view returns and view variances.
+     * @param computeCovariance Also form the n x n posterior covariance (O(n^2 k)).
+     * @throws std::invalid_argument for inconsistent dimensions or non-positive view variances.
+     */
+    Result posterior(const std::vector<double>& priorReturns, const Views& views, bool computeCovariance = false) const;
+
+private:
+    FactorizationCache& cache; ///< Shared covariance and its Cholesky factor.
+    double tau;                ///< Prior uncertainty scaling.
+    double risk_aversion;      ///< Risk aversion delta.
+};
+
+#endif // BLACK_LITTERMAN_HPP
@@ -0,0 +1,264 @@
+#include "GeneticAlgorithm.hpp"
+#include "../utils/BatchEvaluator.hpp"
+#include "../utils/Instrumentation.hpp"
+#include "../utils/LinearAlgebra.hpp"
+#include "../utils/Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr std::size_t BREED_BLOCK = 256;   // Children bred per counter-seeded generator
+constexpr std::size_t FITNESS_ROWS = 64;   // Genomes unpacked per QUBO GEMM
+constexpr std::size_t PORTFOLIO_ROWS = 1024; // Genomes unpacked per BatchEvaluator call
+constexpr unsigned int INITIAL_GENERATION = 0xFFFFFFFFu;
+
+// Rejects genomes whose gene count differs from the dimension a fitness function was built for
+void checkGenes(std::size_t genes, std::size_t n) {
+    if (genes != n) {
+        throw std::invalid_argument("Genome length " + std::to_string(genes) + " does not match the fitness dimension " +
+                                    std::to_string(n) + ".");
+    }
+}
+
+// Writes the genes of a packed genome as 0/1 values of type T
+template <typename T>
+void unpack(const std::uint64_t* genome, std::size_t genes, T* out) {
+    for (std::size_t i = 0; i < genes; ++i) {
+        out[i] = static_cast<T>((genome[i / 64] >> (i % 64)) & 1);
+    }
+}
+
+// x^T Q x for a batch of genomes: X_block * Q by GEMM, then the row-wise dot with X_block
+template <typename T>
+void quboEnergies(const std::vector<T>& Q, std::size_t n, const std::uint64_t* genomes, std::size_t count,
+                  std::size_t words, double* fitness, int numThreads) {
+    const std::size_t numBlocks = (count + FITNESS_ROWS - 1) / FITNESS_ROWS;
+    Parallel::forRange(0, numBlocks, numThreads, [&](std::size_t firstBlock, std::size_t lastBlock, int) {
+        std::vector<T> x(FITNESS_ROWS * n);
+        std::vector<T> product(FITNESS_ROWS * n);
+        for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+            const std::size_t r0 = block * FITNESS_ROWS;
+            const std::size_t rows = std::min(FITNESS_ROWS, count - r0);
+            for (std::size_t r = 0; r < rows; ++r) unpack(genomes + (r0 + r) * words, n, x.data() + r * n);
+            LinearAlgebra::gemm(rows, n, n, x.data(), n, Q.data(), n, product.data(), n, false, 1);
+            for (std::size_t r = 0; r < rows; ++r) {
+                double energy = 0.0;
+                for (std::size_t j = 0; j < n; ++j) energy += static_cast<double>(product[r * n + j]) * x[r * n + j];
+                fitness[r0 + r] = energy;
+            }
+        }
+    });
+}
+
+} // namespace
+
+GeneticAlgorithm::GeneticAlgorithm(std::size_t genes, BatchFitness fitness, const Settings& settings)
+    : genes(genes), words((genes + 63) / 64),
+      last_mask(genes % 64 == 0 ? ~std::uint64_t(0) : (std::uint64_t(1) << (genes % 64)) - 1),
+      fitness(std::move(fitness)), settings(settings) {
+    if (genes == 0) {
+        throw std::invalid_argument("Genomes must have at least one gene.");
+    }
+    if (settings.populationSize < 2 || settings.tournamentSize < 1 || settings.elites >= settings.populationSize) {
+        throw std::invalid_argument("Population must exceed the elite count and hold at least two individuals.");
+    }
+    if (settings.crossoverRate < 0.0 || settings.crossoverRate > 1.0 || settings.mutationRate < 0.0 ||
+        settings.mutationRate > 1.0 || settings.initialDensity < 0.0 || settings.initialDensity > 1.0) {
+        throw std::invalid_argument("Rates and densities must lie in [0, 1].");
+    }
+    current.genomes.assign(settings.populationSize * words, 0);
+    current.fitness.assign(settings.populationSize, 0.0);
+    next.genomes.assign(settings.populationSize * words, 0);
+    next.fitness.assign(settings.populationSize, 0.0);
+}
+
+template <typename Generator>
+void GeneticAlgorithm::breed(std::size_t first, std::size_t last, double mutationRate, Generator& gen) {
+    const std::size_t population = settings.populationSize;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double logKeep = mutationRate < 1.0 ? std::log1p(-mutationRate) : 0.0;
+
+    auto tournament = [&]() {
+        std::size_t best = gen() % population;
+        for (int k = 1; k < settings.tournamentSize; ++k) {
+            const std::size_t challenger = gen() % population;
+            if (current.fitness[challenger] < current.fitness[best]) best = challenger;
+        }
+        return current.genomes.data() + best * words;
+    };
+
+    for (std::size_t c = first; c < last; ++c) {
+        std::uint64_t* child = next.genomes.data() + c * words;
+        const std::uint64_t* a = tournament();
+        const std::uint64_t* b = tournament();
+
+        if (uniform(gen) < settings.crossoverRate) {
+            if (settings.crossover == Crossover::Uniform) {
+                for (std::size_t w = 0; w < words; ++w) {
+                    const std::uint64_t mask = gen();
+                    child[w] = (a[w] & mask) | (b[w] & ~mask);
+                }
+            } else {
+                const std::size_t cut = genes > 1 ? 1 + gen() % (genes - 1) : genes;
+                const std::size_t cutWord = cut / 64;
+                const std::uint64_t low = (std::uint64_t(1) << (cut % 64)) - 1;
+                for (std::size_t w = 0; w < words; ++w) {
+                    child[w] = w < cutWord ? a[w] : w > cutWord ? b[w] : (a[w] & low) | (b[w] & ~low);
+                }
+            }
+        } else {
+            std::copy(a, a + words, child);
+        }
+
+        // Geometric skip sampling: jump straight to the next mutated gene
+        if (mutationRate >= 1.0) {
+            for (std::size_t w = 0; w < words; ++w) child[w] = ~child[w];
+        } else if (mutationRate > 0.0) {
+            double position = std::floor(std::log(1.0 - uniform(gen)) / logKeep);
+            while (position < static_cast<double>(genes)) {
+                const std::size_t i = static_cast<std::size_t>(position);
+                child[i / 64] ^= std::uint64_t(1) << (i % 64);
+                position += 1.0 + std::floor(std::log(1.0 - uniform(gen)) / logKeep);
+            }
+        }
+        child[words - 1] &= last_mask;
+    }
+}
+
+GeneticAlgorithm::Result GeneticAlgorithm::run() {
+    QPO_SCOPED_TIMER("GeneticAlgorithm::run");
+    const std::size_t population = settings.populationSize;
+    const double mutationRate = settings.mutationRate > 0.0 ? settings.mutationRate : 1.0 / static_cast<double>(genes);
+    const std::size_t numBlocks = (population + BREED_BLOCK - 1) / BREED_BLOCK;
+
+    // Random initial population, one generator per block like the breeding below
+    Parallel::forRange(0, numBlocks, settings.numThreads, [&](std::size_t firstBlock, std::size_t lastBlock, int) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+            std::seed_seq seq{settings.seed, INITIAL_GENERATION, static_cast<unsigned int>(block)};
+            std::mt19937_64 gen(seq);
+            const std::size_t end = std::min(population, (block + 1) * BREED_BLOCK);
+            for (std::size_t c = block * BREED_BLOCK; c < end; ++c) {
+                std::uint64_t* genome = current.genomes.data() + c * words;
+                if (settings.initialDensity == 0.5) {
+                    for (std::size_t w = 0; w < words; ++w) genome[w] = gen();
+                } else {
+                    std::fill(genome, genome + words, 0);
+                    for (std::size_t i = 0; i < genes; ++i) {
+                        if (uniform(gen) < settings.initialDensity) genome[i / 64] |= std::uint64_t(1) << (i % 64);
+                    }
+                }
+                genome[words - 1] &= last_mask;
+            }
+        }
+    });
+    fitness(current.genomes.data(), population, genes, words, current.fitness.data());
+
+    Result result;
+    std::vector<std::uint64_t> best(words);
+    double bestFitness = std::numeric_limits<double>::infinity();
+    auto recordBest = [&]() {
+        const std::size_t index = std::min_element(current.fitness.begin(), current.fitness.end()) - current.fitness.begin();
+        if (current.fitness[index] < bestFitness) {
+            bestFitness = current.fitness[index];
+            std::copy(current.genomes.begin() + index * words, current.genomes.begin() + (index + 1) * words, best.begin());
+        }
+        result.bestFitness.push_back(current.fitness[index]);
+        QPO_TRACE_VALUE("GeneticAlgorithm::run.bestFitness", current.fitness[index]);
+    };
+    recordBest();
+
+    std::vector<std::size_t> order(population);
+    for (int generation = 1; generation <= settings.generations; ++generation) {
+        // Elites survive unchanged and keep their fitness
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + settings.elites, order.end(),
+                          [this](std::size_t l, std::size_t r) { return current.fitness[l] < current.fitness[r]; });
+        for (std::size_t e = 0; e < settings.elites; ++e) {
+            std::copy(current.genomes.begin() + order[e] * words, current.genomes.begin() + (order[e] + 1) * words,
+                      next.genomes.begin() + e * words);
+            next.fitness[e] = current.fitness[order[e]];
+        }
+
+        Parallel::forRange(0, numBlocks, settings.numThreads, [&](std::size_t firstBlock, std::size_t lastBlock, int) {
+            for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+                std::seed_seq seq{settings.seed, static_cast<unsigned int>(generation), static_cast<unsigned int>(block)};
+                std::mt19937_64 gen(seq);
+                const std::size_t first = std::max(settings.elites, block * BREED_BLOCK);
+                const std::size_t last = std::min(population, (block + 1) * BREED_BLOCK);
+                if (first < last) breed(first, last, mutationRate, gen);
+            }
+        });
+        fitness(next.genomes.data() + settings.elites * words, population - settings.elites, genes, words,
+                next.fitness.data() + settings.elites);
+
+        std::swap(current, next);
+        recordBest();
+    }
+
+    result.solution = decode(best.data(), genes);
+    result.fitness = bestFitness;
+    return result;
+}
+
+std::vector<int> GeneticAlgorithm::decode(const std::uint64_t* genome, std::size_t genes) {
+    std::vector<int> solution(genes);
+    unpack(genome, genes, solution.data());
+    return solution;
+}
+
+GeneticAlgorithm::BatchFitness GeneticAlgorithm::quboFitness(const boost::numeric::ublas::matrix<double>& QUBO_matrix,
+                                                             int numThreads, bool singlePrecision) {
+    if (QUBO_matrix.size1() != QUBO_matrix.size2()) {
+        throw std::invalid_argument("QUBO matrix must be square.");
+    }
+    const std::size_t n = QUBO_matrix.size1();
+    auto Q = std::make_shared<std::vector<double>>(QUBO_matrix.data().begin(), QUBO_matrix.data().end());
+    if (singlePrecision) {
+        auto singleQ = std::make_shared<std::vector<float>>(Q->begin(), Q->end());
+        return [singleQ, n, numThreads](const std::uint64_t* genomes, std::size_t count, std::size_t genes,
+                                        std::size_t words, double* fitness) {
+            checkGenes(genes, n);
+            quboEnergies(*singleQ, n, genomes, count, words, fitness, numThreads);
+        };
+    }
+    return [Q, n, numThreads](const std::uint64_t* genomes, std::size_t count, std::size_t genes, std::size_t words,
+                              double* fitness) {
+        checkGenes(genes, n);
+        quboEnergies(*Q, n, genomes, count, words, fitness, numThreads);
+    };
+}
+
+GeneticAlgorithm::BatchFitness GeneticAlgorithm::meanVarianceFitness(const std::vector<double>& expectedReturns,
+                                                                     const boost::numeric::ublas::matrix<double>& covariance,
+                                                                     double riskAversion, int numThreads) {
+    auto evaluator = std::make_shared<BatchEvaluator>(expectedReturns, covariance, 0.0, numThreads);
+    const std::size_t n = expectedReturns.size();
+    return [evaluator, n, riskAversion](const std::uint64_t* genomes, std::size_t count, std::size_t genes,
+                                        std::size_t words, double* fitness) {
+        checkGenes(genes, n);
+        std::vector<double> weights(std::min(count, PORTFOLIO_ROWS) * n);
+        for (std::size_t r0 = 0; r0 < count; r0 += PORTFOLIO_ROWS) {
+            const std::size_t rows = std::min(PORTFOLIO_ROWS, count - r0);
+            for (std::size_t r = 0; r < rows; ++r) {
+                double* w = weights.data() + r * n;
+                unpack(genomes + (r0 + r) * words, n, w);
+                const double selected = std::accumulate(w, w + n, 0.0);
+                if (selected > 0.0) {
+                    for (std::size_t i = 0; i < n; ++i) w[i] /= selected;
+                }
+            }
+            auto scores = evaluator->evaluate(weights.data(), rows);
+            for (std::size_t r = 0; r < rows; ++r) {
+                fitness[r0 + r] = riskAversion * scores[r].variance - scores[r].expectedReturn;
+            }
+        }
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#ifndef GENETIC_ALGORITHM_HPP
+#define GENETIC_ALGORITHM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for QUBO and covariance
+
+/**
+ * @class GeneticAlgorithm
+ * @brief Binary genetic algorithm for asset selection with a structure-of-arrays population.
+ *
+ * A generation is a single arena holding every genome as bit-packed 64-bit words (population x words,
+ * contiguous) next to a flat fitness array; no memory is allocated per individual. Two generations are
+ * allocated up front and swapped after every step, so breeding writes straight into the next arena.
+ *
+ * Each generation keeps the elite individuals, then fills the rest with children of tournament-selected
+ * parents, combined by uniform or one-point crossover on whole 64-bit words and mutated by geometric
+ * skip sampling (cost proportional to the number of flipped genes). Children are bred in fixed-size
+ * blocks with counter-seeded generators, so a run is reproducible for a given seed regardless of the
+ * thread count. Fitness (lower is better) is computed for a whole generation at once by a batch fitness
+ * function, such as the QUBO energy or the mean-variance objective below.
+ */
+class GeneticAlgorithm {
+public:
+    /**
+     * @brief Scores count genomes of genes bits stored in words 64-bit words each, writing one fitness value
+     *        per genome. A fitness built for another gene count throws std::invalid_argument.
+     */
+    using BatchFitness = std::function<void(const std::uint64_t* genomes, std::size_t count, std::size_t genes,
+                                            std::size_t words, double* fitness)>;
+
+    /// How two parent genomes are combined.
+    enum class Crossover {
+        Uniform, ///< Every gene taken from either parent with probability 1/2.
+        OnePoint ///< Genes before a random cut from the first parent, the rest from the second.
+    };
+
+    /**
+     * @brief Parameters of a genetic algorithm run.
+     */
+    struct Settings {
+        std::size_t populationSize = 1024; ///< Individuals per generation.
+        int generations = 200;             ///< Generations to evolve.
+        int tournamentSize = 3;            ///< Individuals competing in every parent selection.
+        Crossover crossover = Crossover::Uniform; ///< Crossover operator.
+        double crossoverRate = 0.9;        ///< Probability a child is a crossover rather than a parent copy.
+        double mutationRate = 0.0;         ///< Per-gene flip probability, 0 to use 1 / genes.
+        std::size_t elites = 2;            ///< Best individuals copied unchanged into the next generation.
+        double initialDensity = 0.5;       ///< Probability a gene is set in the random initial population.
+        unsigned int seed = 42;            ///< Seed of the run.
+        int numThreads = 0;                ///< Worker threads for breeding, 0 to use every hardware thread.
+    };
+
+    /**
+     * @brief Outcome of a genetic algorithm run.
+     */
+    struct Result {
+        std::vector<int> solution;      ///< Best genome found, one 0/1 entry per gene.
+        double fitness = 0.0;           ///< Fitness of the best genome.
+        std::vector<double> bestFitness; ///< Best fitness of every generation, including the initial one.
+    };
+
+    /**
+     * @brief Constructor for the GeneticAlgorithm class.
+     *
+     * @param genes Number of genes (assets or QUBO variables).
+     * @param fitness Batch fitness function; lower values are better.
+     * @param settings Run parameters.
+     * @throws std::invalid_argument for an empty genome or inconsistent settings.
+     */
+    GeneticAlgorithm(std::size_t genes, BatchFitness fitness, const Settings& settings);
+
+    /**
+     * @brief Evolves the population for the configured number of generations.
+     *
+     * @throws std::invalid_argument if the fitness function was built for a different number of genes.
+     */
+    Result run();
+
+    /**
+     * @brief Fitness computing the QUBO energy x^T Q x of every genome.
+     *
+     * Genomes are unpacked in blocks of rows and scored with a blocked GEMM X * Q followed by a row-wise
+     * dot with X; blocks are spread over threads.
+     *
+     * @param QUBO_matrix Square QUBO matrix.
+     * @param numThreads Worker threads, 0 to use every hardware thread.
+     * @param singlePrecision Run the GEMM in float. Q is rounded to float and each row is accumulated in single
+     *                        precision, so energies differ from the double result by a relative error growing with n.
+     */
+    static BatchFitness quboFitness(const boost::numeric::ublas::matrix<double>& QUBO_matrix, int numThreads = 0,
+                                    bool singlePrecision = false);
+
+    /**
+     * @brief Fitness riskAversion * w^T Sigma w - w^T mu of the equally weighted portfolio of the selected assets.
+     *
+     * Scored through BatchEvaluator; an empty selection has zero return and zero risk.
+     */
+    static BatchFitness meanVarianceFitness(const std::vector<double>& expectedReturns,
+                                            const boost::numeric::ublas::matrix<double>& covariance,
+                                            double riskAversion, int numThreads = 0);
+
+    /**
+     * @brief Unpacks a bit-packed genome into one 0/1 entry per gene.
+     */
+    static std::vector<int> decode(const std::uint64_t* genome, std::size_t genes);
+
+private:
+    /**
+     * @brief One generation: genomes and fitness as separate contiguous arrays.
+     */
+    struct Generation {
+        std::vector<std::uint64_t> genomes; ///< populationSize x words bit-packed genomes.
+        std::vector<double> fitness;        ///< Fitness of every genome.
+    };
+
+    std::size_t genes;         ///< Genes per genome.
+    std::size_t words;         ///< 64-bit words per genome.
+    std::uint64_t last_mask;   ///< Valid bits of the last word.
+    BatchFitness fitness;      ///< Batch fitness function.
+    Settings settings;         ///< Run parameters.
+    Generation current;        ///< Generation being selected from.
+    Generation next;           ///< Generation being bred into.
+
+    /**
+     * @brief Breeds children [first, last) of the next generation with the given generator.
+     */
+    template <typename Generator>
+    void breed(std::size_t first, std::size_t last, double mutationRate, Generator& gen);
+};
+
+#endif // GENETIC_ALGORITHM_HPP
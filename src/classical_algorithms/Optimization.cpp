@@ -1,7 +1,12 @@
 #include "Optimization.hpp"
+#include "../utils/Checkpoint.hpp"
+#include "../utils/Instrumentation.hpp"
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <random>
-#include <iostream>
+#include <stdexcept>
+#include <utility>
 
 std::vector<double> Optimization::gradientDescent(
     const std::function<double(const std::vector<double>&)>& costFunction,
@@ -10,6 +15,7 @@ std::vector<double> Optimization::gradientDescent(
     double learningRate,
     int maxIterations
 ) {
+    QPO_SCOPED_TIMER("Optimization::gradientDescent");
     std::vector<double> params = initialParams;
 
     for (int i = 0; i < maxIterations; ++i) {
@@ -19,7 +25,7 @@ std::vector<double> Optimization::gradientDescent(
         }
 
         double cost = costFunction(params);
-        std::cout << "Iteration " << i + 1 << " | Cost: " << cost << std::endl;
+        QPO_TRACE_VALUE("Optimization::gradientDescent.cost", cost);
 
         if (cost < 1e-6) {
             break; // Convergence condition
@@ -36,40 +42,117 @@ std::vector<int> Optimization::simulatedAnnealing(
     double coolingRate,
     int maxIterations
 ) {
-    std::vector<int> state = initialState;
-    std::vector<int> bestState = state;
-    double bestEnergy = energyFunction(state);
-
     std::random_device rd;
-    std::mt19937 gen(rd());
+    return simulatedAnnealing(energyFunction, std::move(initialState), initialTemperature, coolingRate, maxIterations, rd());
+}
+
+std::vector<int> Optimization::simulatedAnnealing(
+    const std::function<double(const std::vector<int>&)>& energyFunction,
+    std::vector<int> initialState,
+    double initialTemperature,
+    double coolingRate,
+    int maxIterations,
+    unsigned int seed
+) {
+    return simulatedAnnealing(energyFunction, std::move(initialState), initialTemperature, coolingRate, maxIterations, seed,
+                              CheckpointSettings());
+}
+
+std::vector<int> Optimization::simulatedAnnealing(
+    const std::function<double(const std::vector<int>&)>& energyFunction,
+    std::vector<int> initialState,
+    double initialTemperature,
+    double coolingRate,
+    int maxIterations,
+    unsigned int seed,
+    const CheckpointSettings& checkpoint
+) {
+    QPO_SCOPED_TIMER("Optimization::simulatedAnnealing");
+    std::vector<int> state = std::move(initialState);
+    std::vector<int> bestState;
+    double currentEnergy = 0.0;
+    double bestEnergy = 0.0;
+
+    std::mt19937 gen(seed);
     std::uniform_real_distribution<> dist(0.0, 1.0);
 
     double temperature = initialTemperature;
+    int iter = 0;
+    bool cooled = false;
 
-    for (int iter = 0; iter < maxIterations; ++iter) {
-        std::vector<int> newState = state;
+    std::unique_ptr<CheckpointWriter> writer;
+    Checkpoint saved;
+    if (!checkpoint.path.empty() && saved.load(checkpoint.path)) {
+        if (saved.getUnsigned("sa.seed") != seed || saved.getDouble("sa.initialTemperature") != initialTemperature ||
+            saved.getDouble("sa.coolingRate") != coolingRate || saved.getInts("sa.state").size() != state.size()) {
+            throw std::invalid_argument("Checkpoint was written by a different annealing run.");
+        }
+        state = saved.getInts("sa.state");
+        bestState = saved.getInts("sa.best");
+        currentEnergy = saved.getDouble("sa.energy");
+        bestEnergy = saved.getDouble("sa.bestEnergy");
+        temperature = saved.getDouble("sa.temperature");
+        iter = static_cast<int>(saved.getUnsigned("sa.iteration"));
+        cooled = saved.getUnsigned("sa.cooled") != 0;
+        saved.getEngine("sa.rng", gen);
+    } else {
+        bestState = state;
+        currentEnergy = energyFunction(state);
+        bestEnergy = currentEnergy;
+    }
+    if (!checkpoint.path.empty()) {
+        writer = std::make_unique<CheckpointWriter>(checkpoint.path);
+    }
 
-        // Perturb the state (random bit flip)
-        int index = gen() % state.size();
-        newState[index] = 1 - newState[index];
+    auto snapshot = [&]() {
+        Checkpoint current;
+        current.setValue("sa.seed", static_cast<std::uint64_t>(seed));
+        current.setValue("sa.initialTemperature", initialTemperature);
+        current.setValue("sa.coolingRate", coolingRate);
+        current.setValue("sa.iteration", static_cast<std::uint64_t>(iter));
+        current.setValue("sa.cooled", static_cast<std::uint64_t>(cooled));
+        current.setValues("sa.state", state);
+        current.setValues("sa.best", bestState);
+        current.setValue("sa.energy", currentEnergy);
+        current.setValue("sa.bestEnergy", bestEnergy);
+        current.setValue("sa.temperature", temperature);
+        current.setEngine("sa.rng", gen);
+        return current;
+    };
+
+    const int start = iter;
+    const std::size_t interval = static_cast<std::size_t>(std::max(0, checkpoint.interval));
+    for (; iter < maxIterations && !cooled; ++iter) {
+        if (writer) {
+            writer->maybeCheckpoint(static_cast<std::size_t>(iter), static_cast<std::size_t>(start), interval, snapshot,
+                                    "Simulated annealing stopped at iteration");
+        }
 
-        double currentEnergy = energyFunction(state);
-        double newEnergy = energyFunction(newState);
+        // Perturb the state in place (random bit flip), undoing the flip if the move is rejected
+        int index = gen() % state.size();
+        state[index] = 1 - state[index];
+        double newEnergy = energyFunction(state);
 
         if (newEnergy < currentEnergy || dist(gen) < exp((currentEnergy - newEnergy) / temperature)) {
-            state = newState;
+            currentEnergy = newEnergy;
+            QPO_TRACE_VALUE("Optimization::simulatedAnnealing.energy", newEnergy);
             if (newEnergy < bestEnergy) {
-                bestState = newState;
+                bestState = state;
                 bestEnergy = newEnergy;
             }
+        } else {
+            state[index] = 1 - state[index];
         }
 
         temperature *= coolingRate;
 
         if (temperature < 1e-6) {
-            break; // Stop if temperature is too low
+            cooled = true; // Stop if temperature is too low
         }
     }
 
+    if (writer) {
+        writer->finish(snapshot());
+    }
     return bestState;
 }
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <functional>
+#include <string>
 
 class Optimization {
 public:
@@ -25,6 +26,36 @@ public:
         double coolingRate,
         int maxIterations
     );
+
+    // Simulated Annealing with an explicit RNG seed, for reproducible benchmark runs
+    static std::vector<int> simulatedAnnealing(
+        const std::function<double(const std::vector<int>&)>& energyFunction,
+        std::vector<int> initialState,
+        double initialTemperature,
+        double coolingRate,
+        int maxIterations,
+        unsigned int seed
+    );
+
+    // Periodic checkpoints of a long annealing run, written off the compute thread
+    struct CheckpointSettings {
+        std::string path;  // Checkpoint file; an existing file is resumed from
+        int interval = 0;  // Iterations between checkpoints, 0 for none besides the final state
+    };
+
+    // Seeded Simulated Annealing that resumes from and checkpoints to checkpoint.path. A resumed run returns
+    // exactly what the uninterrupted run would have; maxIterations may be raised to continue a finished run.
+    // Throws CheckpointInterrupted after saving at the next iteration, whatever the interval, if Checkpoint::requestStop
+    // was called.
+    static std::vector<int> simulatedAnnealing(
+        const std::function<double(const std::vector<int>&)>& energyFunction,
+        std::vector<int> initialState,
+        double initialTemperature,
+        double coolingRate,
+        int maxIterations,
+        unsigned int seed,
+        const CheckpointSettings& checkpoint
+    );
 };
 
 #endif // CLASSICAL_OPTIMIZATION_HPP
@@ -0,0 +1,93 @@
+#include "RiskParity.hpp"
+#include "../utils/Instrumentation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+RiskParity::RiskParity(FactorizationCache& cache) : cache(cache), warm_version(0) {}
+
+RiskParity::Result RiskParity::solve(const std::vector<double>& riskBudgets) {
+    return solve(riskBudgets, Settings());
+}
+
+RiskParity::Result RiskParity::solve(const std::vector<double>& riskBudgets, const Settings& settings) {
+    QPO_SCOPED_TIMER("RiskParity::solve");
+    // One snapshot for the whole solve, so the warm start, dimension and covariance always agree
+    const auto state = cache.snapshot();
+    const std::size_t n = state->dimension;
+    const std::vector<double>& sigma = state->covariance;
+    if (n == 0) {
+        throw std::invalid_argument("Covariance matrix must be set before solving.");
+    }
+    if (!riskBudgets.empty() && riskBudgets.size() != n) {
+        throw std::invalid_argument("Risk budgets must have one entry per asset.");
+    }
+
+    std::vector<double> budgets = riskBudgets.empty() ? std::vector<double>(n, 1.0) : riskBudgets;
+    const double budgetSum = std::accumulate(budgets.begin(), budgets.end(), 0.0);
+    for (double& b : budgets) {
+        if (!(b > 0.0)) {
+            throw std::invalid_argument("Risk budgets must be positive.");
+        }
+        b /= budgetSum;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!(sigma[i * n + i] > 0.0)) {
+            throw std::invalid_argument("Covariance diagonal must be positive.");
+        }
+    }
+
+    std::vector<double> y(n);
+    if (warm_version == state->version && warm_start.size() == n) {
+        y = warm_start;
+    } else {
+        for (std::size_t i = 0; i < n; ++i) y[i] = std::sqrt(budgets[i] / sigma[i * n + i]) / std::sqrt(static_cast<double>(n));
+    }
+
+    // sigmaY = Sigma y, kept up to date after every coordinate step
+    std::vector<double> sigmaY(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) sigmaY[i] += sigma[i * n + j] * y[j];
+    }
+
+    Result result;
+    for (result.sweeps = 1; result.sweeps <= settings.maxSweeps; ++result.sweeps) {
+        for (std::size_t i = 0; i < n; ++i) {
+            // Root of sigma_ii y_i^2 + c_i y_i - b_i = 0 with c_i = (Sigma y)_i - sigma_ii y_i
+            const double diagonal = sigma[i * n + i];
+            const double c = sigmaY[i] - diagonal * y[i];
+            const double updated = (-c + std::sqrt(c * c + 4.0 * diagonal * budgets[i])) / (2.0 * diagonal);
+            const double step = updated - y[i];
+            if (step != 0.0) {
+                const double* column = sigma.data() + i * n; // Symmetric, so row i is column i
+                for (std::size_t j = 0; j < n; ++j) sigmaY[j] += step * column[j];
+                y[i] = updated;
+            }
+        }
+
+        double residual = 0.0;
+        for (std::size_t i = 0; i < n; ++i) residual = std::max(residual, std::fabs(y[i] * sigmaY[i] - budgets[i]));
+        QPO_TRACE_VALUE("RiskParity::solve.residual", residual);
+        if (residual <= settings.tolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+    result.sweeps = std::min(result.sweeps, settings.maxSweeps);
+    warm_version = state->version;
+    warm_start = y;
+
+    const double total = std::accumulate(y.begin(), y.end(), 0.0);
+    result.weights.resize(n);
+    result.riskContributions.resize(n);
+    double variance = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        result.weights[i] = y[i] / total;
+        variance += y[i] * sigmaY[i];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        result.riskContributions[i] = y[i] * sigmaY[i] / variance;
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#ifndef RISK_PARITY_HPP
+#define RISK_PARITY_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../utils/FactorizationCache.hpp"
+
+/**
+ * @class RiskParity
+ * @brief Long-only risk-budgeting portfolios by cyclical coordinate descent.
+ *
+ * The weights solve min_y 1/2 y^T Sigma y - sum_i b_i ln(y_i) and are then normalized, w = y / sum(y);
+ * at the optimum every asset's risk contribution w_i (Sigma w)_i is proportional to its budget b_i.
+ * Each coordinate step has a closed form given (Sigma y)_i, and the product Sigma y is updated in O(n)
+ * after every step instead of being recomputed, so a full sweep costs O(n^2).
+ *
+ * The solver reads the covariance from a shared FactorizationCache. While the covariance version is
+ * unchanged, the previous solution is used as the starting point, so adjusting risk budgets converges
+ * in a few sweeps.
+ */
+class RiskParity {
+public:
+    /**
+     * @brief Convergence controls.
+     */
+    struct Settings {
+        double tolerance = 1e-10; ///< Maximum |y_i (Sigma y)_i - b_i| at convergence.
+        int maxSweeps = 10000;    ///< Maximum passes over all coordinates.
+    };
+
+    /**
+     * @brief Risk-budgeting portfolio and diagnostics.
+     */
+    struct Result {
+        std::vector<double> weights;           ///< Portfolio weights, summing to one.
+        std::vector<double> riskContributions; ///< Fraction of the portfolio variance contributed by each asset.
+        int sweeps = 0;                        ///< Sweeps performed.
+        bool converged = false;                ///< Whether the tolerance was met.
+    };
+
+    /**
+     * @brief Constructor for the RiskParity class.
+     *
+     * @param cache Cache holding the covariance; it must outlive the solver.
+     */
+    explicit RiskParity(FactorizationCache& cache);
+
+    /**
+     * @brief Computes the portfolio whose risk contributions match the budgets.
+     *
+     * @param riskBudgets Positive budget per asset (normalized internally), empty for equal risk contributions.
+     * @param settings Convergence controls.
+     * @throws std::invalid_argument if the budgets do not match the covariance or are not positive.
+     */
+    Result solve(const std::vector<double>& riskBudgets, const Settings& settings);
+
+    /**
+     * @brief Computes the risk-budgeting portfolio with the default convergence controls.
+     */
+    Result solve(const std::vector<double>& riskBudgets);
+
+private:
+    FactorizationCache& cache;        ///< Shared covariance.
+    std::uint64_t warm_version;       ///< Covariance version of the warm start.
+    std::vector<double> warm_start;   ///< Unnormalized solution y of the previous call.
+};
+
+#endif // RISK_PARITY_HPP
@@ -0,0 +1,299 @@
+#include "TabuSearch.hpp"
+#include "../utils/Instrumentation.hpp"
+#include "../utils/Parallel.hpp"
+#include "../utils/WorkStealingPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr double ENERGY_EPSILON = 1e-12;
+constexpr int WAVE_SEARCHES_PER_THREAD = 4; // Default wave size per worker thread, so stragglers rarely idle the pool
+
+// One-flip move evaluation for E(x) = sum_i d_i x_i + sum_{i<j} S_ij x_i x_j with S = Q + Q^T off the diagonal.
+// field[i] = sum_j S_ij x_j, so flipping x_i changes the energy by (1 - 2 x_i) (d_i + field[i]).
+class FlipState {
+public:
+    FlipState(const std::vector<double>& coupling, const std::vector<double>& diagonal)
+        : coupling(coupling), diagonal(diagonal), n(diagonal.size()), x(n, 0), field(n, 0.0), energy(0.0) {}
+
+    void reset(const std::vector<int>& assignment) {
+        x = assignment;
+        energy = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double* row = coupling.data() + i * n;
+            double sum = 0.0;
+            for (std::size_t j = 0; j < n; ++j) sum += row[j] * x[j];
+            field[i] = sum;
+            if (x[i]) energy += diagonal[i] + 0.5 * sum;
+        }
+    }
+
+    double delta(std::size_t i) const {
+        return (x[i] ? -1.0 : 1.0) * (diagonal[i] + field[i]);
+    }
+
+    void flip(std::size_t k) {
+        energy += delta(k);
+        const double sign = x[k] ? -1.0 : 1.0;
+        x[k] = 1 - x[k];
+        const double* column = coupling.data() + k * n; // Symmetric, so row k is column k
+        for (std::size_t i = 0; i < n; ++i) field[i] += sign * column[i];
+    }
+
+    const std::vector<double>& coupling;
+    const std::vector<double>& diagonal;
+    std::size_t n;
+    std::vector<int> x;
+    std::vector<double> field;
+    double energy;
+};
+
+// Fixed-capacity pool of the best distinct solutions. Only the coordinating thread inserts, between
+// waves, so the searches of a wave may read it concurrently without synchronisation.
+class ElitePool {
+public:
+    explicit ElitePool(std::size_t capacity) : limit(capacity) {
+        elites.reserve(capacity);
+    }
+
+    // Adds the candidate if it is not already present and the pool has room or a worse elite to replace
+    bool tryInsert(const std::vector<int>& x, double energy) {
+        std::size_t worst = 0;
+        for (std::size_t i = 0; i < elites.size(); ++i) {
+            if (std::abs(elites[i].energy - energy) <= ENERGY_EPSILON && elites[i].x == x) {
+                return false;
+            }
+            if (elites[i].energy > elites[worst].energy) {
+                worst = i;
+            }
+        }
+        if (elites.size() < limit) {
+            elites.push_back({x, energy});
+            return true;
+        }
+        if (elites[worst].energy <= energy) {
+            return false;
+        }
+        elites[worst] = {x, energy};
+        return true;
+    }
+
+    const std::vector<int>& solution(std::size_t index) const { return elites[index].x; }
+    double energy(std::size_t index) const { return elites[index].energy; }
+    std::size_t size() const { return elites.size(); }
+
+private:
+    struct Elite {
+        std::vector<int> x;
+        double energy;
+    };
+
+    std::size_t limit;
+    std::vector<Elite> elites;
+};
+
+// Walks from the initiating toward the guiding solution, always taking the best remaining differing flip,
+// and leaves the state at the best intermediate point (endpoints excluded)
+void relink(FlipState& state, const std::vector<int>& initiating, const std::vector<int>& guiding, std::mt19937& gen) {
+    state.reset(initiating);
+    std::vector<std::size_t> differing;
+    for (std::size_t i = 0; i < state.n; ++i) {
+        if (initiating[i] != guiding[i]) differing.push_back(i);
+    }
+    if (differing.size() < 2) {
+        // Nearly identical elites: perturb instead so the search does not restart where it ended
+        std::vector<int> perturbed = initiating;
+        const std::size_t flips = std::max<std::size_t>(1, state.n / 10);
+        for (std::size_t f = 0; f < flips; ++f) {
+            const std::size_t i = gen() % state.n;
+            perturbed[i] = 1 - perturbed[i];
+        }
+        state.reset(perturbed);
+        return;
+    }
+
+    std::vector<int> best;
+    double bestEnergy = std::numeric_limits<double>::infinity();
+    while (differing.size() > 1) {
+        std::size_t pick = 0;
+        double pickDelta = std::numeric_limits<double>::infinity();
+        for (std::size_t k = 0; k < differing.size(); ++k) {
+            const double d = state.delta(differing[k]);
+            if (d < pickDelta) {
+                pickDelta = d;
+                pick = k;
+            }
+        }
+        state.flip(differing[pick]);
+        differing[pick] = differing.back();
+        differing.pop_back();
+        if (state.energy < bestEnergy) {
+            bestEnergy = state.energy;
+            best = state.x;
+        }
+    }
+    state.reset(best);
+}
+
+// Tabu search from the current state; returns the best assignment seen and counts the moves made
+std::vector<int> tabuSearch(FlipState& state, const TabuSearch::Settings& settings, int tenure, std::mt19937& gen,
+                            const std::atomic<bool>& stop, long long& moves, double& bestEnergy) {
+    const std::size_t n = state.n;
+    std::vector<long long> tabuUntil(n, 0);
+    std::vector<int> best = state.x;
+    bestEnergy = state.energy;
+    long long lastImprovement = 0;
+
+    for (long long iter = 0; iter < settings.maxIterations; ++iter) {
+        if ((iter & 255) == 0 && stop.load(std::memory_order_relaxed)) {
+            break;
+        }
+        long long chosen = -1;
+        double chosenDelta = std::numeric_limits<double>::infinity();
+        unsigned int ties = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double d = state.delta(i);
+            const bool aspiration = state.energy + d < bestEnergy - ENERGY_EPSILON;
+            if (tabuUntil[i] > iter && !aspiration) {
+                continue;
+            }
+            if (d < chosenDelta - ENERGY_EPSILON) {
+                chosen = static_cast<long long>(i);
+                chosenDelta = d;
+                ties = 1;
+            } else if (d <= chosenDelta + ENERGY_EPSILON && gen() % ++ties == 0) {
+                chosen = static_cast<long long>(i); // Reservoir choice among equally good moves
+            }
+        }
+        ++moves;
+        if (chosen < 0) {
+            continue; // Every move is tabu and none aspirates; wait for tenures to expire
+        }
+
+        state.flip(static_cast<std::size_t>(chosen));
+        tabuUntil[chosen] = iter + tenure + static_cast<long long>(gen() % (settings.tenureJitter + 1));
+        if (state.energy < bestEnergy - ENERGY_EPSILON) {
+            bestEnergy = state.energy;
+            best = state.x;
+            lastImprovement = iter;
+            if (bestEnergy <= settings.targetEnergy) {
+                break;
+            }
+        } else if (iter - lastImprovement >= settings.stallIterations) {
+            break;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+TabuSearch::Result TabuSearch::solve(const QUBOMatrix& QUBO_matrix, const Settings& settings) {
+    QPO_SCOPED_TIMER("TabuSearch::solve");
+    const std::size_t n = QUBO_matrix.size1();
+    if (QUBO_matrix.size2() != n || n == 0) {
+        throw std::invalid_argument("QUBO matrix must be square and non-empty.");
+    }
+    if (settings.restarts <= 0 || settings.eliteSize <= 0 || settings.waveSize < 0 || settings.tenureJitter < 0) {
+        throw std::invalid_argument("Restarts and elite size must be positive and the wave size and tenure jitter non-negative.");
+    }
+
+    std::vector<double> coupling(n * n, 0.0);
+    std::vector<double> diagonal(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        diagonal[i] = QUBO_matrix(i, i);
+        for (std::size_t j = 0; j < n; ++j) {
+            if (i != j) coupling[i * n + j] = QUBO_matrix(i, j) + QUBO_matrix(j, i);
+        }
+    }
+    const int tenure = settings.tenure > 0 ? settings.tenure
+                                           : static_cast<int>(std::min<std::size_t>(20, n / 4)) + 1;
+
+    ElitePool elites(static_cast<std::size_t>(settings.eliteSize));
+    std::atomic<bool> stop(false);
+    std::atomic<int> searches(0);
+    std::atomic<long long> totalMoves(0);
+
+    // Searches run in waves that all see the elite pool as it was when the wave started; the wave's
+    // results enter the pool in restart order afterwards, so the outcome does not depend on scheduling
+    const int threads = Parallel::threadCount(settings.numThreads);
+    const int waveSize = settings.waveSize > 0 ? settings.waveSize : WAVE_SEARCHES_PER_THREAD * threads;
+    std::vector<std::vector<int>> waveBest(static_cast<std::size_t>(waveSize));
+    std::vector<double> waveEnergy(static_cast<std::size_t>(waveSize));
+    std::vector<char> waveRan(static_cast<std::size_t>(waveSize));
+    // A single-threaded solve runs its searches inline instead of starting a one-worker pool
+    std::unique_ptr<WorkStealingPool> pool = threads > 1 ? std::make_unique<WorkStealingPool>(threads) : nullptr;
+    for (int first = 0; first < settings.restarts && !stop.load(); first += waveSize) {
+        const int wave = std::min(waveSize, settings.restarts - first);
+        std::fill(waveRan.begin(), waveRan.end(), 0);
+        for (int slot = 0; slot < wave; ++slot) {
+            auto search = [&, slot]() {
+                if (stop.load()) {
+                    return;
+                }
+                const int restart = first + slot;
+                std::seed_seq seq{settings.seed, static_cast<unsigned int>(restart)};
+                std::mt19937 gen(seq);
+                std::uniform_real_distribution<> dist(0.0, 1.0);
+                FlipState state(coupling, diagonal);
+
+                const std::size_t available = elites.size();
+                if (available >= 2 && dist(gen) < settings.relinkProbability) {
+                    const std::size_t a = gen() % available;
+                    const std::size_t b = (a + 1 + gen() % (available - 1)) % available;
+                    relink(state, elites.solution(a), elites.solution(b), gen);
+                } else {
+                    std::vector<int> start(n);
+                    for (int& bit : start) bit = static_cast<int>(gen() & 1);
+                    state.reset(start);
+                }
+
+                long long moves = 0;
+                waveBest[slot] = tabuSearch(state, settings, tenure, gen, stop, moves, waveEnergy[slot]);
+                waveRan[slot] = 1;
+                if (waveEnergy[slot] <= settings.targetEnergy) {
+                    stop.store(true);
+                }
+                searches.fetch_add(1);
+                totalMoves.fetch_add(moves);
+            };
+            if (pool) {
+                pool->submit(search);
+            } else {
+                search();
+            }
+        }
+        if (pool) {
+            pool->wait();
+        }
+        for (int slot = 0; slot < wave; ++slot) {
+            if (waveRan[slot]) elites.tryInsert(waveBest[slot], waveEnergy[slot]);
+        }
+    }
+
+    Result result;
+    result.searches = searches.load();
+    result.moves = totalMoves.load();
+    result.energy = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < elites.size(); ++i) {
+        result.eliteEnergies.push_back(elites.energy(i));
+        if (elites.energy(i) < result.energy) {
+            result.energy = elites.energy(i);
+            result.solution = elites.solution(i);
+        }
+    }
+    std::sort(result.eliteEnergies.begin(), result.eliteEnergies.end());
+    QPO_COUNTER("TabuSearch::solve.moves", result.moves);
+    return result;
+}
+
+std::vector<int> TabuSearch::solveQUBO(const QUBOMatrix& QUBO_matrix, unsigned int seed) {
+    Settings settings;
+    settings.seed = seed;
+    return solve(QUBO_matrix, settings).solution;
+}
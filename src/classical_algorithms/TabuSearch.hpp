@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef TABU_SEARCH_HPP
+#define TABU_SEARCH_HPP
+
+#include <limits>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for QUBO
+
+/**
+ * @class TabuSearch
+ * @brief Multi-start tabu search with path relinking for QUBO problems min x^T Q x, x in {0,1}^n.
+ *
+ * Each search performs one-flip moves. The energy change of flipping every variable is kept in an
+ * incrementally updated field vector, so choosing the best move costs O(n) and applying it costs O(n)
+ * instead of re-evaluating the quadratic form. A flipped variable stays tabu for a (jittered) tenure
+ * unless flipping it would beat the best energy of the search (aspiration).
+ *
+ * Many searches run as tasks on a work-stealing thread pool, in waves of waveSize (inline on the calling
+ * thread when numThreads is 1, so callers that parallelise elsewhere start no pool). The best solution
+ * of each search goes to an elite pool. Once the pool holds two elites, new searches may start from the
+ * best point on the path relinking two random elites instead of from a random assignment.
+ *
+ * Every search of a wave sees the elite pool as it was when the wave started. The wave's results enter
+ * the pool in restart order once the whole wave is done, so only the coordinating thread ever writes it.
+ * With an explicit waveSize, a fixed seed therefore reproduces the run for any numThreads; the default
+ * wave size grows with the thread count, so it reproduces the run for a fixed numThreads. The exception
+ * is a finite targetEnergy: reaching it cuts the running searches short at a timing-dependent point.
+ */
+class TabuSearch {
+public:
+    using QUBOMatrix = boost::numeric::ublas::matrix<double>;
+
+    /**
+     * @brief Parameters of a multi-start tabu search.
+     */
+    struct Settings {
+        int restarts = 32;               ///< Independent searches submitted to the thread pool.
+        int maxIterations = 20000;       ///< Maximum one-flip moves per search.
+        int stallIterations = 2000;      ///< Moves without improvement after which a search stops.
+        int tenure = 0;                  ///< Base tabu tenure, 0 to use min(20, n / 4) + 1.
+        int tenureJitter = 5;            ///< Random extra tenure drawn from [0, tenureJitter].
+        int eliteSize = 8;               ///< Capacity of the shared elite pool.
+        double relinkProbability = 0.5;  ///< Chance that a search starts from a path-relinked elite pair.
+        double targetEnergy = -std::numeric_limits<double>::infinity(); ///< Stop every search once reached.
+        int waveSize = 0;                ///< Searches between elite pool updates, 0 for four per worker thread.
+        unsigned int seed = 42;          ///< Seed of search r is derived from seed and r; see the class notes on reproducibility.
+        int numThreads = 0;              ///< Worker threads, 0 to use every hardware thread.
+    };
+
+    /**
+     * @brief Outcome of a multi-start tabu search.
+     */
+    struct Result {
+        std::vector<int> solution;        ///< Best assignment found.
+        double energy = 0.0;              ///< Energy x^T Q x of the best assignment.
+        int searches = 0;                 ///< Searches that actually ran (fewer if the target was hit early).
+        long long moves = 0;              ///< Total one-flip moves over all searches.
+        std::vector<double> eliteEnergies; ///< Energies in the final elite pool, ascending.
+    };
+
+    /**
+     * @brief Runs the multi-start tabu search.
+     *
+     * @param QUBO_matrix Square QUBO matrix; it need not be symmetric.
+     * @param settings Search parameters.
+     * @return The best solution together with search statistics.
+     * @throws std::invalid_argument if the matrix is not square or the settings are inconsistent.
+     */
+    static Result solve(const QUBOMatrix& QUBO_matrix, const Settings& settings);
+
+    /**
+     * @brief Convenience overload with default settings and the given seed, returning the best assignment.
+     */
+    static std::vector<int> solveQUBO(const QUBOMatrix& QUBO_matrix, unsigned int seed);
+};
+
+#endif // TABU_SEARCH_HPP
@@ -5,6 +5,12 @@
 #include "quantum_algorithms/GroverSearch.hpp"
 #include "quantum_algorithms/VQE.hpp"
 #include "quantum_algorithms/QuantumAnnealing.hpp"
+#include "utils/Checkpoint.hpp"
+#include "utils/Instrumentation.hpp"
+#include "utils/OptimizationService.hpp"
+#include <csignal>
+#include <cstring>
+#include <string>
 
 /**
  * Helper function to generate a sample QUBO matrix for Quantum Annealing.
@@ -26,7 +32,53 @@ boost::numeric::ublas::matrix<double> generateSampleQUBOMatrix(int size) {
     return QUBO_matrix;
 }
 
-int main() {
+/**
+ * Signal handler for SIGTERM and SIGINT: asks every checkpointing solver to save its state and stop.
+ * Checkpoint::requestStop only sets an atomic flag, so it is safe to call here.
+ */
+extern "C" void requestCheckpointStop(int) {
+    Checkpoint::requestStop();
+}
+
+int main(int argc, char* argv[]) {
+    // Command line: [--serve] [--checkpoint <file>]
+    bool serve = false;
+    std::string checkpointPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--serve") == 0) {
+            serve = true;
+        } else if (std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            checkpointPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--serve] [--checkpoint <file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Persistent mode: keep market data and solver state resident and answer requests on stdin/stdout.
+    if (serve) {
+        std::ios::sync_with_stdio(false); // Lets the service see input that is already waiting on stdin
+        Instrumentation::startPeriodicDump("logs/performance_logs.log", 1000);
+        int status = 0;
+        {
+            OptimizationService service;
+            status = service.run(std::cin, std::cout);
+        }
+        Instrumentation::stopPeriodicDump();
+        return status;
+    }
+
+    // With a checkpoint file, a preemption signal saves the annealer's state so a rerun resumes from it.
+    // Without one nothing would save, so the signals keep their default action.
+    if (!checkpointPath.empty()) {
+        std::signal(SIGTERM, requestCheckpointStop);
+        std::signal(SIGINT, requestCheckpointStop);
+    }
+
+    // Dump solver timers and counters to the performance log while the simulation runs.
+    Instrumentation::startPeriodicDump("logs/performance_logs.log", 1000);
+    int status = 0;
+
     try {
         // Set up initial parameters for a 4-qubit quantum system
         int num_qubits = 4;
@@ -80,6 +132,7 @@ int main() {
 
         // Initialize the Quantum Annealing solver with the number of qubits.
         QuantumAnnealing annealer(num_qubits);
+        annealer.setCheckpoint(checkpointPath, 100);
 
         // Solve the QUBO problem using Quantum Annealing and print the solution.
         std::vector<int> annealing_result = annealer.solveQUBO(QUBO_matrix);
@@ -94,11 +147,19 @@ int main() {
         // Print a message indicating that the Quantum Portfolio Optimization simulation is complete.
         std::cout << "Quantum Portfolio Optimization simulation complete." << std::endl;
 
+    } catch (const CheckpointInterrupted& ex) {
+        // Stopped by a signal after saving; a distinct exit code lets a job scheduler requeue the run.
+        std::cerr << ex.what() << " Rerun with --checkpoint " << checkpointPath << " to resume." << std::endl;
+        status = 2;
     } catch (const std::exception& ex) {
         // Catch and handle any exceptions that may occur during the execution.
         std::cerr << "An error occurred: " << ex.what() << std::endl;
     }
 
-    // Return 0 to indicate successful execution of the program.
-    return 0;
+    // Write the remaining events to the log and export them for chrome://tracing.
+    Instrumentation::stopPeriodicDump();
+    Instrumentation::exportChromeTrace("logs/performance_trace.json");
+
+    // Return 0 to indicate successful execution of the program, 2 if it was stopped to be resumed.
+    return status;
 }
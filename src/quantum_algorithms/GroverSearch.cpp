@@ -1,28 +1,58 @@
 #include "GroverSearch.hpp"
-#include <iostream>
-#include <boost/numeric/ublas/vector.hpp>
+#include "../utils/Instrumentation.hpp"
+#include "../utils/MemoryArena.hpp"
+#include <algorithm>
+#include <cmath>
+#include <boost/math/constants/constants.hpp>
 
 GroverSearch::GroverSearch(int num_qubits) : num_qubits(num_qubits) {}
 
 int GroverSearch::search(const std::vector<int>& database) {
+    QPO_SCOPED_TIMER("GroverSearch::search");
     int target = 1; // Assume target value is 1 for placeholder
-    boost::numeric::ublas::vector<int> ublas_database(database.size());
-    std::copy(database.begin(), database.end(), ublas_database.begin());
+    int oracle_result = oracle(database, target);
+    if (oracle_result == -1) {
+        return -1;
+    }
+
+    // Amplitude amplification over one real amplitude per entry, in scratch memory
+    const std::size_t size = database.size();
+    const std::size_t marked = static_cast<std::size_t>(std::count(database.begin(), database.end(), target));
+    MemoryArena& scratch = MemoryArena::threadLocal();
+    MemoryArena::Scope scope(scratch);
+    double* state = scratch.allocate<double>(size);
+    std::fill(state, state + size, 1.0 / std::sqrt(static_cast<double>(size)));
 
-    int oracle_result = oracle(ublas_database, target);
-    applyGroverOperator(ublas_database);
+    const int iterations = static_cast<int>(std::floor(boost::math::constants::pi<double>() / 4.0 *
+                                                       std::sqrt(static_cast<double>(size) / static_cast<double>(marked))));
+    for (int i = 0; i < iterations; ++i) {
+        applyGroverOperator(state, database, target);
+    }
 
-    return oracle_result;
+    // Measure the most likely entry and verify it with the oracle, as a real run would
+    const std::size_t measured = static_cast<std::size_t>(std::max_element(state, state + size,
+        [](double a, double b) { return std::fabs(a) < std::fabs(b); }) - state);
+    QPO_TRACE_VALUE("GroverSearch::search.probability", state[measured] * state[measured]);
+    return database[measured] == target ? static_cast<int>(measured) : oracle_result;
 }
 
-int GroverSearch::oracle(const boost::numeric::ublas::vector<int>& database, int target) {
+int GroverSearch::oracle(const std::vector<int>& database, int target) {
     for (size_t i = 0; i < database.size(); ++i) {
         if (database[i] == target) return i;
     }
     return -1; // Target not found
 }
 
-void GroverSearch::applyGroverOperator(boost::numeric::ublas::vector<int>& state) {
-    std::cout << "Applying Grover operator using Boost vector operations" << std::endl;
-    // Placeholder for actual quantum Grover operator
+void GroverSearch::applyGroverOperator(double* state, const std::vector<int>& database, int target) {
+    QPO_TRACE_MESSAGE("GroverSearch::applyGroverOperator");
+    const std::size_t size = database.size();
+    double mean = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (database[i] == target) state[i] = -state[i]; // Oracle phase flip
+        mean += state[i];
+    }
+    mean /= static_cast<double>(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        state[i] = 2.0 * mean - state[i]; // Inversion about the mean
+    }
 }
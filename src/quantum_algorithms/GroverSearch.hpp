@@ -4,7 +4,6 @@
 #define GROVER_SEARCH_H
 
 #include <vector>
-#include <boost/numeric/ublas/vector.hpp>  // Boost for vector operations
 
 /**
  * @class GroverSearch
@@ -34,6 +33,8 @@ public:
      * This function applies the Grover Search algorithm to a given database and attempts to find the target element.
      * The Grover algorithm amplifies the probability amplitude of the target element through successive applications of the Grover operator.
      * 
+     * The database is read in place and the amplitudes live in the calling thread's scratch arena, so repeated searches do not allocate.
+     * 
      * @param database A binary vector representing the database. The target element is assumed to be marked in the database.
      * @return The index of the target element, or -1 if the target is not found.
      */
@@ -48,11 +49,11 @@ private:
      * The oracle is a black-box quantum operation that flips the sign of the amplitude of the target element in the quantum superposition.
      * This marks the target element by applying a negative phase shift to it, making it distinguishable from the other elements.
      * 
-     * @param database A Boost vector representing the binary database.
+     * @param database The binary database.
      * @param target The target element to search for. This is the element that will be marked by the oracle.
      * @return The index of the target element in the database.
      */
-    int oracle(const boost::numeric::ublas::vector<int>& database, int target);
+    int oracle(const std::vector<int>& database, int target);
 
     /**
      * @brief Applies the Grover operator to amplify the amplitude of the target element.
@@ -62,9 +63,11 @@ private:
      * 2. The **diffusion operator** which amplifies the probability of the target element by increasing the amplitude of the marked state.
      * The Grover operator is applied iteratively to increase the probability of finding the target element.
      * 
-     * @param state A Boost vector representing the quantum state, which is a superposition of all possible states. The Grover operator acts on this state.
+     * @param state Real amplitudes of the quantum state, one per database entry. The Grover operator acts on this state in place.
+     * @param database The binary database marking the target entries.
+     * @param target The target element marked by the oracle.
      */
-    void applyGroverOperator(boost::numeric::ublas::vector<int>& state);
+    void applyGroverOperator(double* state, const std::vector<int>& database, int target);
 };
 
 #endif // GROVER_SEARCH_H
@@ -1,7 +1,14 @@
 #include "QAOA.hpp"
+#include "../utils/Checkpoint.hpp"
+#include "../utils/Instrumentation.hpp"
+#include "../utils/Parallel.hpp"
 #include <boost/random.hpp> // Boost for random number generation
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 
 QAOA::QAOA(int num_qubits, int steps) : num_qubits(num_qubits), steps(steps) {}
 
@@ -11,8 +18,81 @@ void QAOA::setParameters(const std::vector<double>& gamma, const std::vector<dou
 }
 
 double QAOA::optimize(const std::vector<double>& problem_instance) {
-    auto solution = runQuantumCircuit();
-    return computeObjective(solution);
+    QPO_SCOPED_TIMER("QAOA::optimize");
+    return computeObjective(runQuantumCircuit(problem_instance));
+}
+
+void QAOA::setSeed(unsigned int seed) {
+    rng.seed(seed);
+}
+
+QAOA::SweepResult QAOA::sweep(const std::vector<double>& problem_instance, const std::vector<std::vector<double>>& gammas,
+                              const std::vector<std::vector<double>>& betas, const std::string& checkpointPath,
+                              std::size_t checkpointInterval) {
+    QPO_SCOPED_TIMER("QAOA::sweep");
+    if (gammas.size() != betas.size()) {
+        throw std::invalid_argument("Every gamma schedule needs a beta schedule.");
+    }
+
+    SweepResult result;
+    result.objective = std::numeric_limits<double>::infinity();
+    std::size_t next = 0;
+    Checkpoint saved;
+    if (!checkpointPath.empty() && saved.load(checkpointPath)) {
+        if (saved.getUnsigned("qaoa.qubits") != static_cast<std::uint64_t>(num_qubits) ||
+            saved.getUnsigned("qaoa.candidates") != gammas.size() || saved.getDoubles("qaoa.problem") != problem_instance) {
+            throw std::invalid_argument("Checkpoint was written by a different QAOA sweep.");
+        }
+        next = saved.getUnsigned("qaoa.next");
+        result.objective = saved.getDouble("qaoa.bestObjective");
+        result.gamma = saved.getDoubles("qaoa.bestGamma");
+        result.beta = saved.getDoubles("qaoa.bestBeta");
+        result.solution = saved.getInts("qaoa.bestSolution");
+        saved.getEngine("qaoa.rng", rng);
+    }
+    std::unique_ptr<CheckpointWriter> writer;
+    if (!checkpointPath.empty()) {
+        writer = std::make_unique<CheckpointWriter>(checkpointPath);
+    }
+
+    auto snapshot = [&]() {
+        Checkpoint current;
+        current.setValue("qaoa.qubits", static_cast<std::uint64_t>(num_qubits));
+        current.setValue("qaoa.candidates", static_cast<std::uint64_t>(gammas.size()));
+        current.setValues("qaoa.problem", problem_instance);
+        current.setValue("qaoa.next", static_cast<std::uint64_t>(next));
+        current.setValue("qaoa.bestObjective", result.objective);
+        current.setValues("qaoa.bestGamma", result.gamma);
+        current.setValues("qaoa.bestBeta", result.beta);
+        current.setValues("qaoa.bestSolution", result.solution);
+        current.setEngine("qaoa.rng", rng);
+        return current;
+    };
+
+    const std::size_t start = next;
+    for (; next < gammas.size(); ++next) {
+        if (writer) {
+            writer->maybeCheckpoint(next, start, checkpointInterval, snapshot, "QAOA sweep stopped at candidate");
+        }
+        setParameters(gammas[next], betas[next]);
+        runQuantumCircuit(problem_instance);
+        const double objective = expected_cost;
+        QPO_TRACE_VALUE("QAOA::sweep.objective", objective);
+        if (objective < result.objective) {
+            result.objective = objective;
+            result.gamma = gammas[next];
+            result.beta = betas[next];
+            result.solution = solution;
+        }
+    }
+
+    if (writer) {
+        writer->finish(snapshot());
+    }
+    if (!result.gamma.empty() || !result.beta.empty()) {
+        setParameters(result.gamma, result.beta);
+    }
+    return result;
 }
 
 double QAOA::computeObjective(const std::vector<int>& solution) {
@@ -23,14 +103,83 @@ double QAOA::computeObjective(const std::vector<int>& solution) {
     return objective;
 }
 
-std::vector<int> QAOA::runQuantumCircuit() {
-    std::vector<int> solution(num_qubits, 1); // Placeholder for actual quantum result
-    boost::random::mt19937 rng;
-    boost::random::uniform_int_distribution<> dist(0, 1);
+const std::vector<int>& QAOA::runQuantumCircuit(const std::vector<double>& problem_instance) {
+    if (problem_instance.size() != static_cast<std::size_t>(num_qubits)) {
+        throw std::invalid_argument("Problem instance must have one weight per qubit.");
+    }
+    if (num_qubits < 1 || num_qubits > MAX_SIMULATED_QUBITS) {
+        throw std::invalid_argument("Number of qubits must be between 1 and " + std::to_string(MAX_SIMULATED_QUBITS) +
+                                    " for state-vector simulation.");
+    }
+    const std::size_t dimension = std::size_t(1) << num_qubits;
+    const int threads = dimension >= (std::size_t(1) << 16) ? 0 : 1; // Small states are not worth forking for
+
+    std::complex<double>* state = amplitudes.acquire(dimension);
+    MemoryArena& scratch = MemoryArena::threadLocal();
+    MemoryArena::Scope scope(scratch);
+    double* cost = scratch.allocate<double>(dimension);
 
-    for (int& bit : solution) {
-        bit = dist(rng); // Random initialization
+    // Diagonal of the problem Hamiltonian: cost[k] = sum of the weights of the set bits of k
+    cost[0] = 0.0;
+    for (std::size_t k = 1; k < dimension; ++k) {
+        std::size_t bit = 0;
+        while (!((k >> bit) & 1)) ++bit;
+        cost[k] = cost[k & (k - 1)] + problem_instance[bit];
     }
 
+    // Uniform superposition, written in parallel so the pages are first touched by the threads using them
+    const double uniform = 1.0 / std::sqrt(static_cast<double>(dimension));
+    Parallel::forRange(0, dimension, threads, [&](std::size_t lo, std::size_t hi, int) {
+        std::fill(state + lo, state + hi, std::complex<double>(uniform, 0.0));
+    });
+
+    const std::size_t layers = std::min({static_cast<std::size_t>(std::max(steps, 0)), gamma.size(), beta.size()});
+    for (std::size_t layer = 0; layer < layers; ++layer) {
+        // Problem unitary exp(-i gamma C) is diagonal
+        Parallel::forRange(0, dimension, threads, [&](std::size_t lo, std::size_t hi, int) {
+            for (std::size_t k = lo; k < hi; ++k) state[k] *= std::polar(1.0, -gamma[layer] * cost[k]);
+        });
+
+        // Mixer exp(-i beta X) on every qubit
+        const double c = std::cos(beta[layer]);
+        const std::complex<double> is(0.0, std::sin(beta[layer]));
+        for (int qubit = 0; qubit < num_qubits; ++qubit) {
+            const std::size_t stride = std::size_t(1) << qubit;
+            Parallel::forRange(0, dimension / 2, threads, [&](std::size_t lo, std::size_t hi, int) {
+                for (std::size_t pair = lo; pair < hi; ++pair) {
+                    const std::size_t low = ((pair >> qubit) << (qubit + 1)) | (pair & (stride - 1));
+                    const std::complex<double> a = state[low];
+                    const std::complex<double> b = state[low | stride];
+                    state[low] = c * a - is * b;
+                    state[low | stride] = c * b - is * a;
+                }
+            });
+        }
+    }
+
+    // <C> = sum_k |psi_k|^2 cost[k], read while the cost diagonal is still in scratch
+    expected_cost = 0.0;
+    for (std::size_t k = 0; k < dimension; ++k) {
+        expected_cost += std::norm(state[k]) * cost[k];
+    }
+
+    // Measure: sample one basis state from the output distribution
+    boost::random::uniform_real_distribution<> dist(0.0, 1.0);
+    const double draw = dist(rng);
+    std::size_t outcome = dimension - 1;
+    double cumulative = 0.0;
+    for (std::size_t k = 0; k < dimension; ++k) {
+        cumulative += std::norm(state[k]);
+        if (draw < cumulative) {
+            outcome = k;
+            break;
+        }
+    }
+    QPO_TRACE_VALUE("QAOA::runQuantumCircuit.probability", std::norm(state[outcome]));
+
+    solution.resize(num_qubits);
+    for (int i = 0; i < num_qubits; ++i) {
+        solution[i] = static_cast<int>((outcome >> i) & 1);
+    }
     return solution;
 }
@@ -3,8 +3,12 @@
 #ifndef QAOA_H
 #define QAOA_H
 
+#include <complex>
+#include <string>
 #include <vector>
 #include <boost/math/constants/constants.hpp> // Boost for constants
+#include <boost/random/mersenne_twister.hpp> // Boost for the measurement RNG
+#include "../utils/MemoryArena.hpp"
 
 /**
  * @class QAOA
@@ -18,6 +22,19 @@
  */
 class QAOA {
 public:
+    /// Largest circuit runQuantumCircuit simulates: 2^30 amplitudes plus the cost diagonal take 24 GiB.
+    static constexpr int MAX_SIMULATED_QUBITS = 30;
+
+    /**
+     * @brief Best parameters found by a sweep.
+     */
+    struct SweepResult {
+        std::vector<double> gamma;  ///< Gamma schedule with the lowest objective.
+        std::vector<double> beta;   ///< Beta schedule with the lowest objective.
+        double objective = 0.0;     ///< Expected cost <C> of the best schedule's output state.
+        std::vector<int> solution;  ///< Bitstring measured for the best schedule.
+    };
+
     /**
      * @brief Constructor for the QAOA class.
      * 
@@ -50,11 +67,45 @@ public:
      */
     double optimize(const std::vector<double>& problem_instance);
 
+    /**
+     * @brief Seeds the random number generator used to measure the circuit.
+     * 
+     * @param seed Seed of the measurement RNG (the default-constructed generator is used otherwise).
+     */
+    void setSeed(unsigned int seed);
+
+    /**
+     * @brief Evaluates a list of candidate (gamma, beta) schedules and keeps the one with the lowest objective.
+     * 
+     * A schedule is scored by the expectation <C> of the problem Hamiltonian over its output state, which ranks
+     * schedules without the noise of a single measurement; the bitstring measured for the best one is returned too.
+     * 
+     * With a checkpoint path the sweep resumes from an existing checkpoint and saves the next candidate index, the best
+     * schedule so far and the RNG state every checkpointInterval candidates on a background thread. A resumed sweep returns
+     * exactly what the uninterrupted sweep would have. The state vector is not saved: it is a function of the parameters
+     * and is rebuilt bit for bit by the next evaluation. The best schedule is left set on the object.
+     * 
+     * @param problem_instance Weight of every qubit in the problem Hamiltonian.
+     * @param gammas Candidate gamma schedules.
+     * @param betas Candidate beta schedules, one per gamma schedule.
+     * @param checkpointPath Checkpoint file, empty to disable checkpointing.
+     * @param checkpointInterval Candidates between checkpoints, 0 for none besides the final state.
+     * @throws std::invalid_argument if the schedules do not pair up or the checkpoint belongs to another sweep.
+     * @throws CheckpointInterrupted after saving at the next candidate, whatever the interval, if Checkpoint::requestStop was called.
+     */
+    SweepResult sweep(const std::vector<double>& problem_instance, const std::vector<std::vector<double>>& gammas,
+                      const std::vector<std::vector<double>>& betas, const std::string& checkpointPath = std::string(),
+                      std::size_t checkpointInterval = 0);
+
 private:
     int num_qubits;           ///< The number of qubits (binary variables) used in the quantum circuit.
     int steps;                ///< The number of steps (layers) in the quantum circuit, controlling the depth of QAOA.
     std::vector<double> gamma; ///< A vector of gamma parameters, used to control the problem Hamiltonian.
     std::vector<double> beta;  ///< A vector of beta parameters, used to control the mixing Hamiltonian.
+    StateBuffer<std::complex<double>> amplitudes; ///< State vector, kept between calls so repeated evaluations do not re-fault 2^n amplitudes.
+    std::vector<int> solution; ///< Measured bitstring, reused between calls.
+    double expected_cost = 0.0; ///< Expectation <C> of the problem Hamiltonian over the last simulated state.
+    boost::random::mt19937 rng; ///< Measurement RNG; its state is saved with every checkpoint.
 
     /**
      * @brief Computes the objective function for a given solution.
@@ -72,10 +123,15 @@ private:
      * 
      * The **runQuantumCircuit** method simulates the execution of the quantum circuit, producing a solution based on the current parameters.
      * It applies the quantum gates parameterized by gamma and beta to the qubits, ultimately producing a state that represents a possible solution to the optimization problem.
+     * The state vector lives in a reusable huge-page buffer and the diagonal of the problem Hamiltonian in the calling thread's scratch arena, so only the first call allocates.
+     * 
+     * @param problem_instance Weight of every qubit in the (diagonal) problem Hamiltonian.
+     * Also stores the expectation <C> of the problem Hamiltonian over the output state in expected_cost.
      * 
-     * @return A binary vector representing the solution generated by the quantum circuit.
+     * @return A binary vector representing the solution generated by the quantum circuit, valid until the next call.
+     * @throws std::invalid_argument if the problem instance does not have one weight per qubit or the circuit has more than MAX_SIMULATED_QUBITS qubits.
      */
-    std::vector<int> runQuantumCircuit();
+    const std::vector<int>& runQuantumCircuit(const std::vector<double>& problem_instance);
 };
 
 #endif // QAOA_H
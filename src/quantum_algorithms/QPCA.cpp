@@ -0,0 +1,348 @@
+#include "QPCA.hpp"
+#include "../utils/Instrumentation.hpp"
+#include "../utils/LinearAlgebra.hpp"
+#include "../utils/Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Orthonormalizes the rows of a (rows x n) in place by modified Gram-Schmidt; dependent rows become zero
+void orthonormalizeRows(std::vector<double>& a, std::size_t rows, std::size_t n) {
+    for (std::size_t r = 0; r < rows; ++r) {
+        double* row = a.data() + r * n;
+        for (int pass = 0; pass < 2; ++pass) { // Second pass restores orthogonality lost to rounding
+            for (std::size_t p = 0; p < r; ++p) {
+                const double* previous = a.data() + p * n;
+                double dot = 0.0;
+                for (std::size_t i = 0; i < n; ++i) dot += row[i] * previous[i];
+                for (std::size_t i = 0; i < n; ++i) row[i] -= dot * previous[i];
+            }
+        }
+        double norm = 0.0;
+        for (std::size_t i = 0; i < n; ++i) norm += row[i] * row[i];
+        norm = std::sqrt(norm);
+        const double scale = norm > 1e-12 ? 1.0 / norm : 0.0;
+        for (std::size_t i = 0; i < n; ++i) row[i] *= scale;
+    }
+}
+
+// Cyclic Jacobi eigendecomposition of a small symmetric matrix; a is destroyed, v receives the eigenvectors as columns
+void jacobiEigen(std::vector<double>& a, std::size_t n, std::vector<double>& values, std::vector<double>& v) {
+    v.assign(n * n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) v[i * n + i] = 1.0;
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double offDiagonal = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t j = i + 1; j < n; ++j) offDiagonal += a[i * n + j] * a[i * n + j];
+        if (offDiagonal < 1e-30) break;
+
+        for (std::size_t p = 0; p < n; ++p) {
+            for (std::size_t q = p + 1; q < n; ++q) {
+                const double apq = a[p * n + q];
+                if (std::fabs(apq) < 1e-300) continue;
+                const double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double akp = a[k * n + p];
+                    const double akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double apk = a[p * n + k];
+                    const double aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double vkp = v[k * n + p];
+                    const double vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    values.resize(n);
+    for (std::size_t i = 0; i < n; ++i) values[i] = a[i * n + i];
+}
+
+double squaredDistance(const double* a, const double* b, std::size_t dims) {
+    double sum = 0.0;
+    for (std::size_t d = 0; d < dims; ++d) sum += (a[d] - b[d]) * (a[d] - b[d]);
+    return sum;
+}
+
+// k-means with k-means++ seeding on points (n x dims); returns the cluster of every point and the centroids
+void kmeans(const std::vector<double>& points, std::size_t n, std::size_t dims, std::size_t clusters, int iterations,
+            std::mt19937& gen, int numThreads, std::vector<std::size_t>& assignment, std::vector<double>& centroids) {
+    centroids.assign(clusters * dims, 0.0);
+    std::vector<double> nearest(n, std::numeric_limits<double>::infinity());
+    std::size_t chosen = gen() % n;
+    for (std::size_t c = 0; c < clusters; ++c) {
+        std::copy(points.begin() + chosen * dims, points.begin() + (chosen + 1) * dims, centroids.begin() + c * dims);
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            nearest[i] = std::min(nearest[i], squaredDistance(points.data() + i * dims, centroids.data() + c * dims, dims));
+            total += nearest[i];
+        }
+        if (total <= 0.0) {
+            chosen = gen() % n; // Every point coincides with a centroid already
+            continue;
+        }
+        double target = std::uniform_real_distribution<double>(0.0, total)(gen);
+        chosen = n - 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            target -= nearest[i];
+            if (target <= 0.0) {
+                chosen = i;
+                break;
+            }
+        }
+    }
+
+    assignment.assign(n, 0);
+    std::vector<std::size_t> counts(clusters);
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        std::vector<char> changed(Parallel::threadCount(numThreads), 0);
+        Parallel::forRange(0, n, numThreads, [&](std::size_t lo, std::size_t hi, int thread) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                std::size_t best = 0;
+                double bestDistance = std::numeric_limits<double>::infinity();
+                for (std::size_t c = 0; c < clusters; ++c) {
+                    const double d = squaredDistance(points.data() + i * dims, centroids.data() + c * dims, dims);
+                    if (d < bestDistance) {
+                        bestDistance = d;
+                        best = c;
+                    }
+                }
+                if (best != assignment[i] || iteration == 0) changed[thread] = 1;
+                assignment[i] = best;
+                nearest[i] = bestDistance;
+            }
+        });
+        if (std::find(changed.begin(), changed.end(), 1) == changed.end()) break;
+
+        std::fill(centroids.begin(), centroids.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            ++counts[assignment[i]];
+            for (std::size_t d = 0; d < dims; ++d) centroids[assignment[i] * dims + d] += points[i * dims + d];
+        }
+        for (std::size_t c = 0; c < clusters; ++c) {
+            if (counts[c] == 0) {
+                // Empty cluster: restart it at the point farthest from its centroid
+                const std::size_t far = std::max_element(nearest.begin(), nearest.end()) - nearest.begin();
+                std::copy(points.begin() + far * dims, points.begin() + (far + 1) * dims, centroids.begin() + c * dims);
+                nearest[far] = 0.0;
+                continue;
+            }
+            for (std::size_t d = 0; d < dims; ++d) centroids[c * dims + d] /= static_cast<double>(counts[c]);
+        }
+    }
+}
+
+double quboEnergy(const std::vector<int>& x, const boost::numeric::ublas::matrix<double>& Q) {
+    double energy = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        if (!x[i]) continue;
+        for (std::size_t j = 0; j < x.size(); ++j) {
+            if (x[j]) energy += Q(i, j);
+        }
+    }
+    return energy;
+}
+
+// Steepest one-flip descent on x^T Q x with an incrementally maintained field (Q + Q^T) x
+void refineSolution(std::vector<int>& x, const boost::numeric::ublas::matrix<double>& Q) {
+    const std::size_t n = x.size();
+    std::vector<double> field(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (x[j] && i != j) field[i] += Q(i, j) + Q(j, i);
+        }
+    }
+    while (true) {
+        std::size_t best = n;
+        double bestDelta = -1e-12;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double delta = (x[i] ? -1.0 : 1.0) * (Q(i, i) + field[i]);
+            if (delta < bestDelta) {
+                bestDelta = delta;
+                best = i;
+            }
+        }
+        if (best == n) break;
+        const double sign = x[best] ? -1.0 : 1.0;
+        x[best] = 1 - x[best];
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i != best) field[i] += sign * (Q(i, best) + Q(best, i));
+        }
+    }
+}
+
+} // namespace
+
+QPCA::Decomposition QPCA::randomizedEigen(const boost::numeric::ublas::matrix<double>& matrix, std::size_t components,
+                                          const Settings& settings) {
+    QPO_SCOPED_TIMER("QPCA::randomizedEigen");
+    const std::size_t n = matrix.size1();
+    if (matrix.size2() != n) {
+        throw std::invalid_argument("Matrix must be square.");
+    }
+    Decomposition decomposition;
+    components = std::min(components, n);
+    if (components == 0) {
+        decomposition.eigenvectors.resize(n, 0);
+        return decomposition;
+    }
+    const std::size_t sketch = std::min(n, components + settings.oversampling);
+    const double* a = &matrix.data()[0];
+
+    // Sketch rows: basis = orth(Omega^T A^(q+1)) for symmetric A, re-orthonormalized after every product,
+    // stored as sketch x n so every basis vector is contiguous
+    std::mt19937 gen(settings.seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> omega(sketch * n);
+    for (double& value : omega) value = normal(gen);
+    std::vector<double> basis(sketch * n);
+    LinearAlgebra::gemm(sketch, n, n, omega.data(), n, a, n, basis.data(), n, false, settings.numThreads);
+    orthonormalizeRows(basis, sketch, n);
+    for (int iteration = 0; iteration < settings.powerIterations; ++iteration) {
+        LinearAlgebra::gemm(sketch, n, n, basis.data(), n, a, n, omega.data(), n, false, settings.numThreads);
+        orthonormalizeRows(omega, sketch, n);
+        basis.swap(omega);
+    }
+
+    // Projected matrix B = Q^T A Q (sketch x sketch), with Q^T = basis
+    std::vector<double> projected(sketch * n);
+    LinearAlgebra::gemm(sketch, n, n, basis.data(), n, a, n, projected.data(), n, false, settings.numThreads);
+    std::vector<double> basisT(n * sketch);
+    for (std::size_t r = 0; r < sketch; ++r)
+        for (std::size_t i = 0; i < n; ++i) basisT[i * sketch + r] = basis[r * n + i];
+    std::vector<double> small(sketch * sketch);
+    LinearAlgebra::gemm(sketch, sketch, n, projected.data(), n, basisT.data(), sketch, small.data(), sketch, false, 1);
+    for (std::size_t i = 0; i < sketch; ++i) {
+        for (std::size_t j = i + 1; j < sketch; ++j) {
+            const double mean = 0.5 * (small[i * sketch + j] + small[j * sketch + i]);
+            small[i * sketch + j] = small[j * sketch + i] = mean;
+        }
+    }
+    std::vector<double> values;
+    std::vector<double> vectors;
+    jacobiEigen(small, sketch, values, vectors);
+
+    std::vector<std::size_t> order(sketch);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&values](std::size_t l, std::size_t r) { return values[l] > values[r]; });
+
+    // Eigenvectors of A: U = Q V
+    decomposition.eigenvalues.resize(components);
+    decomposition.eigenvectors.resize(n, components);
+    for (std::size_t j = 0; j < components; ++j) {
+        const std::size_t source = order[j];
+        decomposition.eigenvalues[j] = values[source];
+        for (std::size_t i = 0; i < n; ++i) {
+            double sum = 0.0;
+            for (std::size_t r = 0; r < sketch; ++r) sum += basisT[i * sketch + r] * vectors[r * sketch + source];
+            decomposition.eigenvectors(i, j) = sum;
+        }
+    }
+    return decomposition;
+}
+
+QPCA::Reduction QPCA::reduce(const QUBOMatrix& QUBO_matrix, const boost::numeric::ublas::matrix<double>& covariance,
+                             const Settings& settings) {
+    QPO_SCOPED_TIMER("QPCA::reduce");
+    const std::size_t n = covariance.size1();
+    if (n == 0 || covariance.size2() != n || QUBO_matrix.size1() != n || QUBO_matrix.size2() != n) {
+        throw std::invalid_argument("QUBO and covariance must be square matrices over the same non-empty asset set.");
+    }
+    const std::size_t clusters = std::max<std::size_t>(1, std::min(settings.clusters, n));
+
+    // Factor loadings sqrt(lambda_j) u_ij as asset features
+    Decomposition decomposition = randomizedEigen(covariance, settings.components, settings);
+    const std::size_t dims = decomposition.eigenvalues.size();
+    std::vector<double> features(n * dims);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < dims; ++j) {
+            features[i * dims + j] = std::sqrt(std::max(0.0, decomposition.eigenvalues[j])) * decomposition.eigenvectors(i, j);
+        }
+    }
+
+    Reduction reduction;
+    reduction.aggregation = settings.aggregation;
+    std::vector<double> centroids;
+    std::mt19937 gen(settings.seed + 1);
+    kmeans(features, n, dims, clusters, std::max(1, settings.kmeansIterations), gen, settings.numThreads,
+           reduction.assignment, centroids);
+
+    reduction.representatives.assign(clusters, n);
+    std::vector<double> closest(clusters, std::numeric_limits<double>::infinity());
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t c = reduction.assignment[i];
+        const double d = squaredDistance(features.data() + i * dims, centroids.data() + c * dims, dims);
+        if (d < closest[c]) {
+            closest[c] = d;
+            reduction.representatives[c] = i;
+        }
+    }
+
+    reduction.reducedQUBO = boost::numeric::ublas::zero_matrix<double>(clusters, clusters);
+    if (settings.aggregation == Aggregation::ClusterSum) {
+        // x_i = z_c(i) gives x^T Q x = z^T Q_red z with Q_red[c][d] = sum of Q over cluster c x cluster d
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t ci = reduction.assignment[i];
+            for (std::size_t j = 0; j < n; ++j) {
+                reduction.reducedQUBO(ci, reduction.assignment[j]) += QUBO_matrix(i, j);
+            }
+        }
+    } else {
+        for (std::size_t c = 0; c < clusters; ++c) {
+            for (std::size_t d = 0; d < clusters; ++d) {
+                const std::size_t rc = reduction.representatives[c];
+                const std::size_t rd = reduction.representatives[d];
+                if (rc < n && rd < n) reduction.reducedQUBO(c, d) = QUBO_matrix(rc, rd);
+            }
+        }
+    }
+    return reduction;
+}
+
+std::vector<int> QPCA::lift(const Reduction& reduction, const std::vector<int>& reducedSolution) {
+    const std::size_t n = reduction.assignment.size();
+    if (reducedSolution.size() != reduction.representatives.size()) {
+        throw std::invalid_argument("Reduced solution must have one entry per cluster.");
+    }
+    std::vector<int> solution(n, 0);
+    if (reduction.aggregation == Aggregation::ClusterSum) {
+        for (std::size_t i = 0; i < n; ++i) solution[i] = reducedSolution[reduction.assignment[i]] ? 1 : 0;
+    } else {
+        for (std::size_t c = 0; c < reducedSolution.size(); ++c) {
+            if (reducedSolution[c] && reduction.representatives[c] < n) solution[reduction.representatives[c]] = 1;
+        }
+    }
+    return solution;
+}
+
+QPCA::Result QPCA::solve(const QUBOMatrix& QUBO_matrix, const boost::numeric::ublas::matrix<double>& covariance,
+                         const QUBOSolver& solver, const Settings& settings) {
+    QPO_SCOPED_TIMER("QPCA::solve");
+    Result result;
+    result.reduction = reduce(QUBO_matrix, covariance, settings);
+    result.reducedSolution = solver(result.reduction.reducedQUBO);
+    result.solution = lift(result.reduction, result.reducedSolution);
+    if (settings.refine) {
+        refineSolution(result.solution, QUBO_matrix);
+    }
+    result.energy = quboEnergy(result.solution, QUBO_matrix);
+    QPO_COUNTER("QPCA::solve.reducedVariables", result.reduction.representatives.size());
+    return result;
+}
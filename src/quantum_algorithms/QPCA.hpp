@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef QPCA_HPP
+#define QPCA_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for covariance and QUBO
+
+/**
+ * @class QPCA
+ * @brief Principal-component reduction stage that shrinks asset-selection QUBOs before they are solved.
+ *
+ * This is the classical counterpart of quantum PCA: the leading eigenpairs of the covariance matrix are
+ * found with a randomized range finder (Gaussian sketch, power iterations, Gram-Schmidt, then a dense
+ * eigendecomposition of the small projected matrix), with every product against the covariance done as
+ * a multithreaded GEMM. Assets are embedded by their factor loadings sqrt(lambda_j) u_ij and grouped by
+ * k-means, and the QUBO over n assets is aggregated into a QUBO over the clusters, which is small enough
+ * for the quantum simulators. The solution of the reduced problem is lifted back to the assets and can
+ * be polished by a one-flip descent on the full QUBO.
+ */
+class QPCA {
+public:
+    using QUBOMatrix = boost::numeric::ublas::matrix<double>;
+
+    /// Any QUBO solver: maps a QUBO matrix to a binary solution vector.
+    using QUBOSolver = std::function<std::vector<int>(const QUBOMatrix&)>;
+
+    /// How assets are represented by the reduced variables.
+    enum class Aggregation {
+        ClusterSum,    ///< A reduced variable selects every asset in its cluster; Q_red = sum of the cluster blocks.
+        Representative ///< A reduced variable selects the asset closest to its cluster centroid.
+    };
+
+    /**
+     * @brief Parameters of the reduction.
+     */
+    struct Settings {
+        std::size_t components = 16;   ///< Leading principal components used as asset features.
+        std::size_t oversampling = 8;  ///< Extra sketch columns for the randomized eigensolver.
+        int powerIterations = 2;       ///< Power iterations sharpening the sketch.
+        std::size_t clusters = 200;    ///< Reduced variables (capped at the number of assets).
+        int kmeansIterations = 50;     ///< Maximum Lloyd iterations.
+        Aggregation aggregation = Aggregation::ClusterSum; ///< Mapping between reduced and full variables.
+        bool refine = true;            ///< Polish the lifted solution with one-flip descent on the full QUBO.
+        unsigned int seed = 42;        ///< Seed of the sketch and of the k-means initialisation.
+        int numThreads = 0;            ///< Worker threads, 0 to use every hardware thread.
+    };
+
+    /**
+     * @brief Leading eigenpairs of a symmetric matrix.
+     */
+    struct Decomposition {
+        std::vector<double> eigenvalues;                  ///< Eigenvalues in descending order.
+        boost::numeric::ublas::matrix<double> eigenvectors; ///< n x k matrix, column j belongs to eigenvalue j.
+    };
+
+    /**
+     * @brief Mapping between assets and reduced variables, with the reduced QUBO.
+     */
+    struct Reduction {
+        std::vector<std::size_t> assignment;      ///< Cluster of every asset.
+        std::vector<std::size_t> representatives; ///< Asset closest to every cluster centroid.
+        QUBOMatrix reducedQUBO;                   ///< QUBO over the reduced variables.
+        Aggregation aggregation = Aggregation::ClusterSum; ///< Mapping used to build reducedQUBO.
+    };
+
+    /**
+     * @brief Outcome of solving a reduced QUBO.
+     */
+    struct Result {
+        std::vector<int> solution;        ///< Lifted (and possibly refined) solution over all assets.
+        double energy = 0.0;              ///< x^T Q x of the solution on the full QUBO.
+        std::vector<int> reducedSolution; ///< Solution returned by the solver on the reduced QUBO.
+        Reduction reduction;              ///< The reduction that was solved.
+    };
+
+    /**
+     * @brief Randomized truncated eigendecomposition of a symmetric positive semi-definite matrix.
+     *
+     * @param matrix Symmetric n x n matrix.
+     * @param components Number of eigenpairs to return (capped at n).
+     * @param settings Oversampling, power iterations, seed and threads are used.
+     * @throws std::invalid_argument if the matrix is not square.
+     */
+    static Decomposition randomizedEigen(const boost::numeric::ublas::matrix<double>& matrix, std::size_t components,
+                                         const Settings& settings);
+
+    /**
+     * @brief Clusters the assets on their principal-component loadings and aggregates the QUBO.
+     *
+     * @param QUBO_matrix QUBO over the assets.
+     * @param covariance Covariance of the same assets.
+     * @param settings Reduction parameters.
+     * @throws std::invalid_argument if the dimensions disagree.
+     */
+    static Reduction reduce(const QUBOMatrix& QUBO_matrix, const boost::numeric::ublas::matrix<double>& covariance,
+                            const Settings& settings);
+
+    /**
+     * @brief Maps a solution of the reduced QUBO back to one entry per asset.
+     */
+    static std::vector<int> lift(const Reduction& reduction, const std::vector<int>& reducedSolution);
+
+    /**
+     * @brief Reduces the QUBO, solves it with the given solver and lifts the solution back.
+     *
+     * @param QUBO_matrix QUBO over the assets.
+     * @param covariance Covariance of the same assets.
+     * @param solver Solver applied to the reduced QUBO (e.g. QuantumAnnealing::solveQUBO or a classical heuristic).
+     * @param settings Reduction parameters.
+     */
+    static Result solve(const QUBOMatrix& QUBO_matrix, const boost::numeric::ublas::matrix<double>& covariance,
+                        const QUBOSolver& solver, const Settings& settings);
+};
+
+#endif // QPCA_HPP
@@ -1,19 +1,126 @@
 #include "QuantumAnnealing.hpp"
+#include "../utils/Checkpoint.hpp"
+#include "../utils/Instrumentation.hpp"
 #include <boost/random.hpp>
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
 
-QuantumAnnealing::QuantumAnnealing(int num_qubits) : num_qubits(num_qubits), temperature(1.0) {}
+QuantumAnnealing::QuantumAnnealing(int num_qubits)
+    : num_qubits(num_qubits), temperature(1.0), cooling_rate(0.95), rungs(200), checkpoint_interval(0) {}
+
+void QuantumAnnealing::setSeed(unsigned int seed) {
+    rng.seed(seed);
+}
+
+void QuantumAnnealing::setSchedule(int rungs, double coolingRate) {
+    if (rungs < 0 || !(coolingRate > 0.0 && coolingRate <= 1.0)) {
+        throw std::invalid_argument("Rungs must be non-negative and the cooling rate in (0, 1].");
+    }
+    this->rungs = rungs;
+    cooling_rate = coolingRate;
+}
+
+void QuantumAnnealing::setCheckpoint(const std::string& path, int interval) {
+    checkpoint_path = path;
+    checkpoint_interval = interval;
+}
 
 std::vector<int> QuantumAnnealing::solveQUBO(const boost::numeric::ublas::matrix<double>& QUBO_matrix) {
-    std::vector<int> state(num_qubits, 1); // Random initial state
-    anneal(state, temperature);
-    return state;
+    QPO_SCOPED_TIMER("QuantumAnnealing::solveQUBO");
+    const std::size_t n = static_cast<std::size_t>(num_qubits);
+    if (QUBO_matrix.size1() != n || QUBO_matrix.size2() != n) {
+        throw std::invalid_argument("QUBO matrix must have one row and column per qubit.");
+    }
+    const std::uint64_t problem = Checkpoint::fingerprint(&QUBO_matrix.data()[0], n * n);
+
+    std::vector<int> state(n);
+    std::vector<int> best;
+    double energy = 0.0;
+    double bestEnergy = 0.0;
+    double current = temperature;
+    int rung = 0;
+
+    Checkpoint saved;
+    if (!checkpoint_path.empty() && saved.load(checkpoint_path)) {
+        if (saved.getUnsigned("annealing.problem") != problem || saved.getUnsigned("annealing.rungs") != static_cast<std::uint64_t>(rungs) ||
+            saved.getDouble("annealing.coolingRate") != cooling_rate) {
+            throw std::invalid_argument("Checkpoint was written by a different annealing run.");
+        }
+        rung = static_cast<int>(saved.getUnsigned("annealing.rung"));
+        state = saved.getInts("annealing.state");
+        best = saved.getInts("annealing.best");
+        energy = saved.getDouble("annealing.energy");
+        bestEnergy = saved.getDouble("annealing.bestEnergy");
+        current = saved.getDouble("annealing.temperature");
+        saved.getEngine("annealing.rng", rng);
+    } else {
+        boost::random::bernoulli_distribution<> coin(0.5);
+        for (int& bit : state) bit = coin(rng) ? 1 : 0; // Random initial state
+        energy = computeEnergy(state, QUBO_matrix);
+        best = state;
+        bestEnergy = energy;
+    }
+    std::unique_ptr<CheckpointWriter> writer;
+    if (!checkpoint_path.empty()) {
+        writer = std::make_unique<CheckpointWriter>(checkpoint_path);
+    }
+
+    auto snapshot = [&]() {
+        Checkpoint checkpoint;
+        checkpoint.setValue("annealing.problem", problem);
+        checkpoint.setValue("annealing.rungs", static_cast<std::uint64_t>(rungs));
+        checkpoint.setValue("annealing.coolingRate", cooling_rate);
+        checkpoint.setValue("annealing.rung", static_cast<std::uint64_t>(rung));
+        checkpoint.setValues("annealing.state", state);
+        checkpoint.setValues("annealing.best", best);
+        checkpoint.setValue("annealing.energy", energy);
+        checkpoint.setValue("annealing.bestEnergy", bestEnergy);
+        checkpoint.setValue("annealing.temperature", current);
+        checkpoint.setEngine("annealing.rng", rng);
+        return checkpoint;
+    };
+
+    const int start = rung;
+    for (; rung < rungs; ++rung) {
+        if (writer) {
+            writer->maybeCheckpoint(static_cast<std::size_t>(rung), static_cast<std::size_t>(start),
+                                    static_cast<std::size_t>(std::max(0, checkpoint_interval)), snapshot,
+                                    "Quantum annealing stopped at rung");
+        }
+        energy += anneal(state, current, QUBO_matrix);
+        if (energy < bestEnergy) {
+            best = state;
+            bestEnergy = energy;
+        }
+        current *= cooling_rate;
+    }
+
+    if (writer) {
+        writer->finish(snapshot());
+    }
+    return best;
 }
 
-void QuantumAnnealing::anneal(std::vector<int>& state, double temperature) {
-    boost::random::mt19937 rng;
-    std::cout << "Starting annealing process at temperature: " << temperature << std::endl;
-    // Placeholder for annealing steps
+double QuantumAnnealing::anneal(std::vector<int>& state, double temperature, const boost::numeric::ublas::matrix<double>& QUBO_matrix) {
+    QPO_TRACE_VALUE("QuantumAnnealing::anneal.temperature", temperature);
+    boost::random::uniform_real_distribution<> dist(0.0, 1.0);
+    double change = 0.0;
+    for (std::size_t i = 0; i < state.size(); ++i) {
+        // Energy change of flipping bit i under x^T Q x
+        double field = QUBO_matrix(i, i);
+        for (std::size_t j = 0; j < state.size(); ++j) {
+            if (j != i && state[j]) field += QUBO_matrix(i, j) + QUBO_matrix(j, i);
+        }
+        const double delta = state[i] ? -field : field;
+        if (delta <= 0.0 || dist(rng) < std::exp(-delta / temperature)) {
+            state[i] = 1 - state[i];
+            change += delta;
+        }
+    }
+    return change;
 }
 
 double QuantumAnnealing::computeEnergy(const std::vector<int>& state, const boost::numeric::ublas::matrix<double>& QUBO_matrix) {
@@ -3,8 +3,10 @@
 #ifndef QUANTUM_ANNEALING_H
 #define QUANTUM_ANNEALING_H
 
+#include <string>
 #include <vector>
 #include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for QUBO
+#include <boost/random/mersenne_twister.hpp> // Boost for the annealing RNG
 
 /**
  * @class QuantumAnnealing
@@ -32,26 +34,61 @@ public:
      * This method uses the Quantum Annealing technique to solve a given QUBO problem, represented by a matrix.
      * It attempts to find the binary vector (state) that minimizes the objective function defined by the QUBO matrix.
      * The annealing process involves gradually reducing the temperature, allowing the system to settle into the ground state (lowest energy configuration).
+     * The temperature follows a geometric ladder with one Metropolis sweep per rung. With a checkpoint set, an existing checkpoint is resumed from and the
+     * ladder position, states, energies and RNG state are saved on a background thread, so a resumed run returns exactly what the uninterrupted run would have.
      * 
      * @param QUBO_matrix The QUBO matrix that defines the objective function to be minimized. This matrix is used to calculate the energy and guide the annealing process.
      * @return A binary vector (vector of 0s and 1s) that represents the solution to the QUBO problem.
+     * @throws std::invalid_argument if the matrix is not num_qubits x num_qubits or the checkpoint belongs to another run.
+     * @throws CheckpointInterrupted after saving at the next rung, whatever the interval, if Checkpoint::requestStop was called.
      */
     std::vector<int> solveQUBO(const boost::numeric::ublas::matrix<double>& QUBO_matrix);
 
+    /**
+     * @brief Seeds the random number generator driving the initial state and the Metropolis moves.
+     * 
+     * @param seed Seed of the annealing RNG (the default-constructed generator is used otherwise).
+     */
+    void setSeed(unsigned int seed);
+
+    /**
+     * @brief Sets the annealing ladder.
+     * 
+     * @param rungs Number of temperatures visited, one sweep over all qubits each.
+     * @param coolingRate Factor applied to the temperature after every rung.
+     */
+    void setSchedule(int rungs, double coolingRate);
+
+    /**
+     * @brief Enables checkpointing of solveQUBO.
+     * 
+     * @param path Checkpoint file, empty to disable checkpointing.
+     * @param interval Rungs between checkpoints, 0 for none besides the final state.
+     */
+    void setCheckpoint(const std::string& path, int interval);
+
 private:
     int num_qubits;               ///< The number of qubits (binary variables) in the QUBO problem.
     double temperature;           ///< The current temperature for the annealing process.
+    double cooling_rate;          ///< Factor applied to the temperature after every rung.
+    int rungs;                    ///< Number of rungs of the annealing ladder.
+    boost::random::mt19937 rng;   ///< Annealing RNG; its state is saved with every checkpoint.
+    std::string checkpoint_path;  ///< Checkpoint file, empty when checkpointing is disabled.
+    int checkpoint_interval;      ///< Rungs between checkpoints.
 
     /**
-     * @brief Performs the annealing process for a given state.
+     * @brief Performs one rung of the annealing process for a given state.
      * 
      * The annealing process involves gradually lowering the temperature to guide the system toward its ground state.
-     * At each temperature step, the state of the system is updated based on the energy landscape.
+     * At each temperature step, the state of the system is updated based on the energy landscape: every qubit is offered a flip,
+     * accepted with the Metropolis probability.
      * 
      * @param state The current state of the system, represented as a binary vector (0s and 1s).
      * @param temperature The current temperature of the system. The temperature is gradually lowered during the annealing process.
+     * @param QUBO_matrix The QUBO matrix that defines the energy function.
+     * @return The change in energy caused by the accepted flips.
      */
-    void anneal(std::vector<int>& state, double temperature);
+    double anneal(std::vector<int>& state, double temperature, const boost::numeric::ublas::matrix<double>& QUBO_matrix);
 
     /**
      * @brief Computes the energy of the given state for a QUBO problem.
@@ -5,8 +5,9 @@
 #include <ql/math/optimization/endcriteria.hpp>
 #include "VQECostFunction.hpp"
 #include <ql/math/array.hpp>
-#include <iostream>
+#include <algorithm>
 #include <stdexcept>
+#include "../utils/Instrumentation.hpp"
 #include "VQECostFunction.hpp"
 
 // Constructor: Initialize with the number of qubits and Hamiltonian
@@ -43,21 +44,23 @@ double VQE::evaluateHamiltonian(const std::vector<double>& params) {
 
 // Function to optimize the parameters
 void VQE::optimizeParameters(std::vector<double>& params) {
+    QPO_SCOPED_TIMER("VQE::optimizeParameters");
     if (params.empty()) {
         throw std::invalid_argument("Initial parameters cannot be empty.");
     }
 
-    QuantLib::Array ql_params(params.size());
-    for (size_t i = 0; i < params.size(); ++i) {
-        ql_params[i] = params[i];
+    // Reuse the optimizer array; it is only reallocated when the number of parameters changes
+    if (ql_params.size() != params.size()) {
+        ql_params = QuantLib::Array(params.size());
     }
+    std::copy(params.begin(), params.end(), ql_params.begin());
 
     // Define the optimizer and end criteria
     QuantLib::LevenbergMarquardt optimizer;
     QuantLib::EndCriteria endCriteria(100, 10, 1e-8, 1e-8, 1e-8);
 
     // Run the optimizer
-    std::cout << "Optimizing parameters using QuantLib Levenberg-Marquardt" << std::endl;
+    QPO_TRACE_MESSAGE("VQE::optimizeParameters.levenbergMarquardt");
     // optimizer.minimize(problem, endCriteria);
 
     // Update params with the optimized results
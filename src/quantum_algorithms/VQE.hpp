@@ -46,6 +46,7 @@ public:
 private:
     int num_qubits;                        ///< The number of qubits in the quantum system.
     std::vector<double> hamiltonian;        ///< The Hamiltonian of the quantum system (used for energy computations).
+    QuantLib::Array ql_params;              ///< Optimizer parameter array, reused between calls.
 
     /**
      * @brief Evaluates the energy of the quantum system given a set of parameters.
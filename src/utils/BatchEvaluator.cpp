@@ -0,0 +1,131 @@
+#include "BatchEvaluator.hpp"
+#include "Instrumentation.hpp"
+#include "LinearAlgebra.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t BATCH_ROWS = 64; // Candidates per GEMM; S = W_block * Sigma stays in L2 for typical universes
+
+} // namespace
+
+BatchEvaluator::BatchEvaluator(const std::vector<double>& expectedReturns, const boost::numeric::ublas::matrix<double>& covariance,
+                               double riskFreeRate, int numThreads)
+    : num_assets(expectedReturns.size()), expected_returns(expectedReturns),
+      risk_free_rate(riskFreeRate), num_threads(numThreads) {
+    if (covariance.size1() != num_assets || covariance.size2() != num_assets) {
+        throw std::invalid_argument("Covariance dimensions must match the number of expected returns.");
+    }
+    this->covariance.assign(covariance.data().begin(), covariance.data().end());
+    covariance_single.assign(this->covariance.begin(), this->covariance.end());
+}
+
+void BatchEvaluator::setConstraints(const Constraints& constraints) {
+    this->constraints = constraints;
+}
+
+std::vector<BatchEvaluator::Evaluation> BatchEvaluator::evaluate(const boost::numeric::ublas::matrix<double>& portfolios,
+                                                                 Precision precision) const {
+    if (portfolios.size2() != num_assets) {
+        throw std::invalid_argument("Portfolio weights must have one column per asset.");
+    }
+    if (portfolios.size1() == 0) {
+        return {};
+    }
+    return evaluate(&portfolios.data()[0], portfolios.size1(), precision);
+}
+
+std::vector<BatchEvaluator::Evaluation> BatchEvaluator::evaluate(const double* weights, std::size_t rows,
+                                                                 Precision precision) const {
+    QPO_SCOPED_TIMER("BatchEvaluator::evaluate");
+    QPO_COUNTER("BatchEvaluator::evaluate.candidates", rows);
+    const std::size_t n = num_assets;
+    std::vector<Evaluation> results(rows);
+    const std::size_t numBlocks = (rows + BATCH_ROWS - 1) / BATCH_ROWS;
+
+    Parallel::forRange(0, numBlocks, num_threads, [&](std::size_t firstBlock, std::size_t lastBlock, int) {
+        std::vector<double> product;
+        std::vector<float> productSingle;
+        std::vector<float> weightsSingle;
+        if (precision == Precision::Single) {
+            productSingle.resize(BATCH_ROWS * n);
+            weightsSingle.resize(BATCH_ROWS * n);
+        } else {
+            product.resize(BATCH_ROWS * n);
+        }
+
+        for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+            const std::size_t r0 = block * BATCH_ROWS;
+            const std::size_t count = std::min(BATCH_ROWS, rows - r0);
+            const double* w = weights + r0 * n;
+
+            // S = W_block * Sigma, then w_r^T Sigma w_r = <S_r, w_r>
+            if (precision == Precision::Single) {
+                std::copy(w, w + count * n, weightsSingle.begin());
+                LinearAlgebra::gemm(count, n, n, weightsSingle.data(), n, covariance_single.data(), n,
+                                    productSingle.data(), n, false, 1);
+                for (std::size_t r = 0; r < count; ++r) {
+                    const float* s = productSingle.data() + r * n;
+                    const double* wr = w + r * n;
+                    double variance = 0.0;
+                    for (std::size_t i = 0; i < n; ++i) variance += static_cast<double>(s[i]) * wr[i];
+                    score(wr, variance, results[r0 + r]);
+                }
+            } else {
+                LinearAlgebra::gemm(count, n, n, w, n, covariance.data(), n, product.data(), n, false, 1);
+                for (std::size_t r = 0; r < count; ++r) {
+                    const double* s = product.data() + r * n;
+                    const double* wr = w + r * n;
+                    double variance = 0.0;
+                    for (std::size_t i = 0; i < n; ++i) variance += s[i] * wr[i];
+                    score(wr, variance, results[r0 + r]);
+                }
+            }
+        }
+    });
+    return results;
+}
+
+void BatchEvaluator::score(const double* w, double variance, Evaluation& evaluation) const {
+    double expectedReturn = 0.0;
+    double total = 0.0;
+    double boundViolation = 0.0;
+    std::size_t holdings = 0;
+    for (std::size_t i = 0; i < num_assets; ++i) {
+        expectedReturn += w[i] * expected_returns[i];
+        total += w[i];
+        boundViolation += std::max(0.0, constraints.minWeight - w[i]) + std::max(0.0, w[i] - constraints.maxWeight);
+        holdings += w[i] != 0.0;
+    }
+
+    evaluation.expectedReturn = expectedReturn;
+    evaluation.variance = std::max(0.0, variance); // Rounding can push a near-riskless portfolio below zero
+    evaluation.volatility = std::sqrt(evaluation.variance);
+    evaluation.sharpeRatio = evaluation.volatility > 0.0 ? (expectedReturn - risk_free_rate) / evaluation.volatility : 0.0;
+    evaluation.budgetViolation = std::max(0.0, std::fabs(total - constraints.budget) - constraints.budgetTolerance);
+    evaluation.boundViolation = boundViolation;
+    evaluation.holdingsViolation =
+        constraints.maxHoldings > 0 && holdings > constraints.maxHoldings ? holdings - constraints.maxHoldings : 0;
+    evaluation.feasible = evaluation.budgetViolation == 0.0 && boundViolation == 0.0 && evaluation.holdingsViolation == 0;
+}
+
+boost::numeric::ublas::matrix<double> BatchEvaluator::equalWeights(const std::vector<std::vector<int>>& selections,
+                                                                   double budget) {
+    const std::size_t assets = selections.empty() ? 0 : selections.front().size();
+    boost::numeric::ublas::matrix<double> weights(selections.size(), assets, 0.0);
+    for (std::size_t r = 0; r < selections.size(); ++r) {
+        if (selections[r].size() != assets) {
+            throw std::invalid_argument("Every selection must cover the same number of assets.");
+        }
+        const auto selected = std::count_if(selections[r].begin(), selections[r].end(), [](int bit) { return bit != 0; });
+        if (selected == 0) continue;
+        const double weight = budget / static_cast<double>(selected);
+        for (std::size_t i = 0; i < assets; ++i) {
+            if (selections[r][i] != 0) weights(r, i) = weight;
+        }
+    }
+    return weights;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#ifndef BATCH_EVALUATOR_HPP
+#define BATCH_EVALUATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for covariance and portfolio weights
+
+/**
+ * @class BatchEvaluator
+ * @brief Scores many candidate portfolios against one universe in a single call.
+ *
+ * For a batch of weight vectors W (one per row) the evaluator computes expected returns W * mu,
+ * variances diag(W * Sigma * W^T), Sharpe ratios and constraint violations. The quadratic form is
+ * evaluated as a blocked GEMM S = W_block * Sigma followed by a row-wise dot of S with W_block, so the
+ * covariance streams through cache once per block of candidates instead of once per candidate.
+ * Blocks of rows are distributed over threads. In single precision the GEMM runs on float copies of
+ * the weights and covariance (halving memory traffic), while the dot products accumulate in double.
+ */
+class BatchEvaluator {
+public:
+    /// Arithmetic used for the covariance product.
+    enum class Precision {
+        Double, ///< Double-precision GEMM.
+        Single  ///< Single-precision GEMM with double accumulation of the row dots.
+    };
+
+    /**
+     * @brief Portfolio constraints checked for every candidate.
+     */
+    struct Constraints {
+        double budget = 1.0;               ///< Required sum of the weights.
+        double budgetTolerance = 1e-6;     ///< Allowed absolute deviation from the budget.
+        double minWeight = -std::numeric_limits<double>::infinity(); ///< Lower bound on every weight.
+        double maxWeight = std::numeric_limits<double>::infinity();  ///< Upper bound on every weight.
+        std::size_t maxHoldings = 0;       ///< Maximum number of non-zero weights, 0 for no limit.
+    };
+
+    /**
+     * @brief Scores of a single candidate portfolio.
+     */
+    struct Evaluation {
+        double expectedReturn = 0.0;     ///< w^T mu.
+        double variance = 0.0;           ///< w^T Sigma w.
+        double volatility = 0.0;         ///< sqrt(w^T Sigma w).
+        double sharpeRatio = 0.0;        ///< (w^T mu - risk-free rate) / volatility, 0 for a riskless portfolio.
+        double budgetViolation = 0.0;    ///< |sum(w) - budget| beyond the tolerance.
+        double boundViolation = 0.0;     ///< Total amount by which weights leave [minWeight, maxWeight].
+        std::size_t holdingsViolation = 0; ///< Non-zero weights beyond maxHoldings.
+        bool feasible = true;            ///< Whether every constraint is satisfied.
+    };
+
+    /**
+     * @brief Constructor for the BatchEvaluator class.
+     *
+     * @param expectedReturns Expected return of each asset.
+     * @param covariance Covariance matrix of the asset returns.
+     * @param riskFreeRate Rate subtracted from the expected return in the Sharpe ratio.
+     * @param numThreads Worker threads, 0 to use every hardware thread.
+     * @throws std::invalid_argument if the dimensions disagree.
+     */
+    BatchEvaluator(const std::vector<double>& expectedReturns, const boost::numeric::ublas::matrix<double>& covariance,
+                   double riskFreeRate = 0.0, int numThreads = 0);
+
+    /**
+     * @brief Replaces the constraints checked by subsequent evaluations.
+     */
+    void setConstraints(const Constraints& constraints);
+
+    /**
+     * @brief Scores every row of a weight matrix.
+     *
+     * @param portfolios Matrix with one candidate per row and one column per asset.
+     * @param precision Arithmetic used for the covariance product.
+     * @return One Evaluation per row.
+     * @throws std::invalid_argument if the column count differs from the number of assets.
+     */
+    std::vector<Evaluation> evaluate(const boost::numeric::ublas::matrix<double>& portfolios,
+                                     Precision precision = Precision::Double) const;
+
+    /**
+     * @brief Scores rows x assets weights stored contiguously in row-major order.
+     */
+    std::vector<Evaluation> evaluate(const double* weights, std::size_t rows, Precision precision = Precision::Double) const;
+
+    /**
+     * @brief Converts binary asset selections (e.g. QUBO solutions) into equally weighted portfolios.
+     *
+     * @param selections One 0/1 vector per candidate; an empty selection yields an all-zero row.
+     * @param budget Total weight spread over the selected assets.
+     * @return Candidates x assets weight matrix.
+     */
+    static boost::numeric::ublas::matrix<double> equalWeights(const std::vector<std::vector<int>>& selections,
+                                                              double budget = 1.0);
+
+    /**
+     * @brief Number of assets in the universe.
+     */
+    std::size_t numAssets() const { return num_assets; }
+
+private:
+    std::size_t num_assets;                 ///< Number of assets.
+    std::vector<double> expected_returns;   ///< Expected return per asset.
+    std::vector<double> covariance;         ///< Covariance matrix, row-major.
+    std::vector<float> covariance_single;   ///< Single-precision copy of the covariance.
+    double risk_free_rate;                  ///< Rate used in the Sharpe ratio.
+    int num_threads;                        ///< Worker threads.
+    Constraints constraints;                ///< Constraints checked for every candidate.
+
+    /**
+     * @brief Fills the return, Sharpe ratio and constraint fields of one candidate given its variance.
+     */
+    void score(const double* w, double variance, Evaluation& evaluation) const;
+};
+
+#endif // BATCH_EVALUATOR_HPP
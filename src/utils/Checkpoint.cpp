@@ -0,0 +1,307 @@
+#include "Checkpoint.hpp"
+#include "Instrumentation.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+const char* const header = "qpo-checkpoint 2";
+
+std::atomic<bool> stopFlag{false};
+
+void writeRaw(std::ostream& out, const void* data, std::size_t bytes) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+}
+
+template <typename T>
+void writeScalar(std::ostream& out, T value) {
+    writeRaw(out, &value, sizeof(value));
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values) {
+    writeScalar<std::uint64_t>(out, values.size());
+    writeRaw(out, values.data(), values.size() * sizeof(T));
+}
+
+template <typename T>
+bool readScalar(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+// Reads a length-prefixed array, refusing lengths the rest of the file cannot hold
+template <typename T>
+bool readArray(std::istream& in, std::uint64_t remaining, std::vector<T>& values) {
+    std::uint64_t count = 0;
+    if (!readScalar(in, count) || count > remaining / sizeof(T)) {
+        return false;
+    }
+    values.resize(static_cast<std::size_t>(count));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+} // namespace
+
+Checkpoint::Entry& Checkpoint::setEntry(const std::string& key, Kind kind) {
+    if (key.empty() || key.find_first_of(" \t\r\n") != std::string::npos) {
+        throw std::invalid_argument("Checkpoint keys must be non-empty and free of whitespace.");
+    }
+    Entry& stored = entries[key];
+    stored = Entry();
+    stored.kind = kind;
+    return stored;
+}
+
+const Checkpoint::Entry& Checkpoint::entry(const std::string& key, Kind kind) const {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        throw std::runtime_error("Checkpoint has no entry '" + key + "'.");
+    }
+    if (it->second.kind != kind) {
+        throw std::runtime_error("Checkpoint entry '" + key + "' has another type.");
+    }
+    return it->second;
+}
+
+void Checkpoint::setValue(const std::string& key, double value) {
+    setEntry(key, Kind::Double).doubles.assign(1, value);
+}
+
+void Checkpoint::setValue(const std::string& key, std::uint64_t value) {
+    setEntry(key, Kind::Unsigned).number = value;
+}
+
+void Checkpoint::setValues(const std::string& key, std::vector<double> values) {
+    setEntry(key, Kind::Doubles).doubles = std::move(values);
+}
+
+void Checkpoint::setValues(const std::string& key, std::vector<int> values) {
+    setEntry(key, Kind::Ints).ints = std::move(values);
+}
+
+double Checkpoint::getDouble(const std::string& key) const {
+    return entry(key, Kind::Double).doubles.front();
+}
+
+std::uint64_t Checkpoint::getUnsigned(const std::string& key) const {
+    return entry(key, Kind::Unsigned).number;
+}
+
+std::vector<double> Checkpoint::getDoubles(const std::string& key) const {
+    return entry(key, Kind::Doubles).doubles;
+}
+
+std::vector<int> Checkpoint::getInts(const std::string& key) const {
+    return entry(key, Kind::Ints).ints;
+}
+
+void Checkpoint::save(const std::string& path) const {
+    QPO_SCOPED_TIMER("Checkpoint::save");
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Could not open checkpoint file: " + temporary);
+        }
+        out << header << '\n';
+        for (const auto& item : entries) {
+            const Entry& stored = item.second;
+            writeScalar<std::uint32_t>(out, static_cast<std::uint32_t>(item.first.size()));
+            writeRaw(out, item.first.data(), item.first.size());
+            writeScalar(out, static_cast<std::uint8_t>(stored.kind));
+            switch (stored.kind) {
+            case Kind::Double:
+            case Kind::Doubles:
+                writeArray(out, stored.doubles);
+                break;
+            case Kind::Unsigned:
+                writeScalar(out, stored.number);
+                break;
+            case Kind::Ints:
+                writeArray(out, stored.ints);
+                break;
+            case Kind::Text:
+                writeScalar<std::uint64_t>(out, stored.text.size());
+                writeRaw(out, stored.text.data(), stored.text.size());
+                break;
+            }
+        }
+        writeScalar<std::uint32_t>(out, 0); // An empty key ends the file, followed by the entry count
+        writeScalar<std::uint64_t>(out, entries.size());
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Could not write checkpoint file: " + temporary);
+        }
+    }
+#if defined(_WIN32)
+    std::remove(path.c_str()); // rename() only replaces an existing file atomically on POSIX
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Could not move checkpoint into place: " + path);
+    }
+}
+
+bool Checkpoint::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    const std::uint64_t size = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+    std::string line;
+    if (!std::getline(in, line) || line != header) {
+        throw std::runtime_error("Not a checkpoint file: " + path);
+    }
+    auto remaining = [&in, size]() { return size - static_cast<std::uint64_t>(in.tellg()); };
+
+    std::map<std::string, Entry> loaded;
+    std::uint32_t keyLength = 0;
+    while (readScalar(in, keyLength)) {
+        if (keyLength == 0) {
+            std::uint64_t count = 0;
+            if (!readScalar(in, count) || count != loaded.size()) {
+                break;
+            }
+            entries.swap(loaded);
+            return true;
+        }
+        if (keyLength > remaining()) {
+            break;
+        }
+        std::string key(keyLength, '\0');
+        std::uint8_t kind = 0;
+        if (!in.read(&key[0], keyLength) || !readScalar(in, kind) || kind > static_cast<std::uint8_t>(Kind::Text)) {
+            break;
+        }
+        Entry& stored = loaded[key];
+        stored.kind = static_cast<Kind>(kind);
+        bool ok = false;
+        switch (stored.kind) {
+        case Kind::Double:
+            ok = readArray(in, remaining(), stored.doubles) && stored.doubles.size() == 1;
+            break;
+        case Kind::Doubles:
+            ok = readArray(in, remaining(), stored.doubles);
+            break;
+        case Kind::Unsigned:
+            ok = readScalar(in, stored.number);
+            break;
+        case Kind::Ints:
+            ok = readArray(in, remaining(), stored.ints);
+            break;
+        case Kind::Text: {
+            std::vector<char> text;
+            ok = readArray(in, remaining(), text);
+            stored.text.assign(text.begin(), text.end());
+            break;
+        }
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    throw std::runtime_error("Checkpoint file is truncated: " + path);
+}
+
+std::uint64_t Checkpoint::fingerprint(const double* values, std::size_t count) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t bits;
+        std::memcpy(&bits, values + i, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+void Checkpoint::requestStop() {
+    stopFlag.store(true, std::memory_order_relaxed);
+}
+
+void Checkpoint::clearStop() {
+    stopFlag.store(false, std::memory_order_relaxed);
+}
+
+bool Checkpoint::stopRequested() {
+    return stopFlag.load(std::memory_order_relaxed);
+}
+
+CheckpointWriter::CheckpointWriter(std::string path) : path(std::move(path)) {
+    worker = std::thread([this]() { run(); });
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+void CheckpointWriter::submit(Checkpoint checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued = std::move(checkpoint);
+        has_queued = true;
+    }
+    wake.notify_one();
+}
+
+void CheckpointWriter::finish(Checkpoint checkpoint) {
+    submit(std::move(checkpoint));
+    flush();
+}
+
+void CheckpointWriter::boundary(Checkpoint checkpoint, bool stop, const char* stage, std::size_t step) {
+    submit(std::move(checkpoint));
+    if (stop) {
+        flush();
+        throw CheckpointInterrupted(std::string(stage) + " " + std::to_string(step) + ".");
+    }
+}
+
+void CheckpointWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return !has_queued && !writing; });
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
+
+std::size_t CheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return writes;
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return has_queued || stopping; });
+        if (!has_queued) {
+            break; // Stopping with nothing left to write
+        }
+        Checkpoint snapshot = std::move(queued);
+        has_queued = false;
+        writing = true;
+        lock.unlock();
+        std::exception_ptr failure;
+        try {
+            snapshot.save(path);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        lock.lock();
+        writing = false;
+        if (failure) {
+            if (!error) error = failure;
+        } else {
+            ++writes;
+        }
+        idle.notify_all();
+    }
+}
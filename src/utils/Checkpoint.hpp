@@ -0,0 +1,231 @@
+#pragma once
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class CheckpointInterrupted
+ * @brief Thrown by a solver that wrote its checkpoint and stopped because Checkpoint::requestStop was called.
+ */
+class CheckpointInterrupted : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @class Checkpoint
+ * @brief Serializable snapshot of a solver's state as named entries.
+ *
+ * Entries keep their values as given; nothing is encoded until save(), which normally runs on a
+ * CheckpointWriter thread, so taking a snapshot costs the compute thread no more than a copy. Doubles are
+ * written as their raw IEEE-754 bytes and random engines through their stream operators, so a solver
+ * restored from a checkpoint continues with exactly the numbers it would have produced had it never
+ * stopped. Files are binary: a header line, one length-prefixed record per entry and an end record that
+ * detects truncated files. Values are in the byte order of the machine that wrote them. save() writes a
+ * temporary file and renames it over the target, so a crash while saving leaves the previous checkpoint intact.
+ *
+ * Long jobs poll stopRequested() at their checkpoint boundaries; requestStop() only sets a lock-free
+ * flag and may be called from a signal handler (e.g. on the SIGTERM sent before a cluster preemption).
+ */
+class Checkpoint {
+public:
+    void setValue(const std::string& key, double value);
+    void setValue(const std::string& key, std::uint64_t value);
+    void setValues(const std::string& key, std::vector<double> values);
+    void setValues(const std::string& key, std::vector<int> values);
+
+    /**
+     * @brief Stores the complete state of a random engine (any engine with operator<<).
+     */
+    template <typename Engine>
+    void setEngine(const std::string& key, const Engine& engine) {
+        std::ostringstream out;
+        out << engine;
+        Entry& stored = setEntry(key, Kind::Text);
+        stored.text = out.str();
+    }
+
+    double getDouble(const std::string& key) const;
+    std::uint64_t getUnsigned(const std::string& key) const;
+    std::vector<double> getDoubles(const std::string& key) const;
+    std::vector<int> getInts(const std::string& key) const;
+
+    /**
+     * @brief Restores a random engine stored with setEngine.
+     */
+    template <typename Engine>
+    void getEngine(const std::string& key, Engine& engine) const {
+        const std::string& state = entry(key, Kind::Text).text;
+        std::istringstream in(state);
+        in >> engine;
+        // Some engines flag end-of-input as failure, so verify by writing the state back instead
+        std::ostringstream check;
+        check << engine;
+        if (check.str() != state) {
+            throw std::runtime_error("Checkpoint entry '" + key + "' is not a random engine state.");
+        }
+    }
+
+    /**
+     * @brief True if the snapshot has an entry with the given key.
+     */
+    bool has(const std::string& key) const { return entries.count(key) > 0; }
+
+    /**
+     * @brief Writes the snapshot to path through a temporary file and an atomic rename.
+     *
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Replaces the snapshot with the contents of path.
+     *
+     * @return false if the file does not exist.
+     * @throws std::runtime_error if the file is truncated or malformed.
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief FNV-1a hash over the bit patterns of the values, for recognising checkpoints of another run.
+     */
+    static std::uint64_t fingerprint(const double* values, std::size_t count);
+
+    /**
+     * @brief Asks every checkpointing solver to save and stop at its next checkpoint. Async-signal-safe.
+     */
+    static void requestStop();
+
+    /**
+     * @brief Clears a stop request so that new jobs run to completion.
+     */
+    static void clearStop();
+
+    /**
+     * @brief True once requestStop has been called (and not cleared).
+     */
+    static bool stopRequested();
+
+private:
+    /// Type of an entry's value; stored in the file.
+    enum class Kind : std::uint8_t { Double, Unsigned, Doubles, Ints, Text };
+
+    /// One named value; only the member matching kind is used.
+    struct Entry {
+        Kind kind = Kind::Double;
+        std::uint64_t number = 0;
+        std::vector<double> doubles;
+        std::vector<int> ints;
+        std::string text;
+    };
+
+    std::map<std::string, Entry> entries; ///< Values by key.
+
+    Entry& setEntry(const std::string& key, Kind kind);
+    const Entry& entry(const std::string& key, Kind kind) const;
+};
+
+/**
+ * @class CheckpointWriter
+ * @brief Writes checkpoints of one job on a background thread.
+ *
+ * submit() only hands the snapshot over; encoding and writing happen off the compute threads. A snapshot
+ * submitted while the previous one is still being written replaces any snapshot still queued, so a
+ * slow file system delays checkpoints instead of stalling the solver. The destructor writes the last
+ * submitted snapshot before returning.
+ *
+ * Solver loops call maybeCheckpoint before every step and finish once they are done, so the interval and
+ * stop semantics are the same for every checkpointing solver.
+ */
+class CheckpointWriter {
+public:
+    /**
+     * @brief Starts the writer thread.
+     *
+     * @param path File every snapshot is written to.
+     */
+    explicit CheckpointWriter(std::string path);
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+    ~CheckpointWriter();
+
+    /**
+     * @brief Queues a snapshot for writing, replacing one that has not been started yet.
+     */
+    void submit(Checkpoint checkpoint);
+
+    /**
+     * @brief Checkpoint boundary before step of a loop that started (or resumed) at start.
+     *
+     * Submits snapshot() every interval steps (never for an interval of 0). Once Checkpoint::requestStop has
+     * been called, it writes snapshot() whatever the interval, waits until it is on disk and throws
+     * CheckpointInterrupted("<stage> <step>."). Nothing happens until the loop has made one step, so a run
+     * restarted while a stop is still pending makes progress before it stops again.
+     *
+     * @param snapshot Callable returning the Checkpoint of the state before step; only called when writing.
+     * @param stage Start of the interruption message, e.g. "Simulated annealing stopped at iteration".
+     */
+    template <typename MakeSnapshot>
+    void maybeCheckpoint(std::size_t step, std::size_t start, std::size_t interval, MakeSnapshot&& snapshot, const char* stage) {
+        if (step <= start) {
+            return;
+        }
+        const bool stop = Checkpoint::stopRequested();
+        if (stop || (interval > 0 && step % interval == 0)) {
+            boundary(snapshot(), stop, stage, step);
+        }
+    }
+
+    /**
+     * @brief Writes the final snapshot of a finished run and blocks until it is on disk.
+     *
+     * @throws std::runtime_error if a write failed.
+     */
+    void finish(Checkpoint checkpoint);
+
+    /**
+     * @brief Blocks until every submitted snapshot is on disk.
+     *
+     * @throws std::runtime_error (rethrown from the writer thread) if a write failed.
+     */
+    void flush();
+
+    /**
+     * @brief Number of snapshots written so far.
+     */
+    std::size_t written() const;
+
+private:
+    std::string path;                  ///< Target file.
+    mutable std::mutex mutex;          ///< Guards every member below.
+    std::condition_variable wake;      ///< Signals a new snapshot or shutdown to the writer.
+    std::condition_variable idle;      ///< Signals that the queue drained.
+    Checkpoint queued;                 ///< Snapshot waiting to be written.
+    bool has_queued = false;           ///< True if queued holds a snapshot.
+    bool writing = false;              ///< True while the writer thread is saving.
+    bool stopping = false;             ///< Set by the destructor.
+    std::size_t writes = 0;            ///< Snapshots written.
+    std::exception_ptr error;          ///< First write failure.
+    std::thread worker;                ///< Writer thread.
+
+    void run();
+
+    /**
+     * @brief Submits a boundary snapshot; on a stop request also flushes and throws CheckpointInterrupted.
+     */
+    void boundary(Checkpoint checkpoint, bool stop, const char* stage, std::size_t step);
+};
+
+#endif // CHECKPOINT_HPP
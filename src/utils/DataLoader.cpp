@@ -0,0 +1,103 @@
+#include "DataLoader.hpp"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<std::vector<double>> DataLoader::readRows(const std::string& path, bool labelColumn) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Unable to open data file: " + path);
+    }
+
+    std::vector<std::vector<double>> rows;
+    std::string line;
+    std::getline(in, line); // Header row with the asset names
+    std::size_t lineNumber = 1;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        std::vector<double> row;
+        std::stringstream cells(line);
+        std::string cell;
+        for (std::size_t column = 1; std::getline(cells, cell, ','); ++column) {
+            if (labelColumn && column == 1) {
+                continue; // Row label such as "Asset_1"
+            }
+            char* end = nullptr;
+            const double value = std::strtod(cell.c_str(), &end);
+            while (end != cell.c_str() && std::isspace(static_cast<unsigned char>(*end))) ++end;
+            if (end == cell.c_str() || *end != '\0') {
+                throw std::runtime_error("Non-numeric cell '" + cell + "' at row " + std::to_string(lineNumber) +
+                                         ", column " + std::to_string(column) + " of data file: " + path);
+            }
+            row.push_back(value);
+        }
+        if (!rows.empty() && row.size() != rows.front().size()) {
+            throw std::runtime_error("Inconsistent row length in data file: " + path);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+boost::numeric::ublas::matrix<double> DataLoader::loadReturns(const std::string& path) {
+    std::vector<std::vector<double>> rows = readRows(path, false);
+    const std::size_t assets = rows.empty() ? 0 : rows.front().size();
+    boost::numeric::ublas::matrix<double> returns(rows.size(), assets);
+    for (std::size_t t = 0; t < rows.size(); ++t) {
+        for (std::size_t i = 0; i < assets; ++i) {
+            returns(t, i) = rows[t][i];
+        }
+    }
+    return returns;
+}
+
+boost::numeric::ublas::matrix<double> DataLoader::loadCovariance(const std::string& path) {
+    std::vector<std::vector<double>> rows = readRows(path, true);
+    if (!rows.empty() && rows.front().size() != rows.size()) {
+        throw std::runtime_error("Covariance matrix must be square: " + path);
+    }
+    boost::numeric::ublas::matrix<double> covariance(rows.size(), rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        for (std::size_t j = 0; j < rows.size(); ++j) {
+            covariance(i, j) = rows[i][j];
+        }
+    }
+    return covariance;
+}
+
+std::vector<double> DataLoader::meanReturns(const boost::numeric::ublas::matrix<double>& returns) {
+    std::vector<double> means(returns.size2(), 0.0);
+    for (std::size_t t = 0; t < returns.size1(); ++t) {
+        for (std::size_t i = 0; i < returns.size2(); ++i) {
+            means[i] += returns(t, i);
+        }
+    }
+    for (double& mean : means) mean /= static_cast<double>(returns.size1());
+    return means;
+}
+
+boost::numeric::ublas::matrix<double> DataLoader::sampleCovariance(const boost::numeric::ublas::matrix<double>& returns) {
+    if (returns.size1() < 2) {
+        throw std::invalid_argument("Sample covariance needs at least two periods.");
+    }
+    const std::size_t periods = returns.size1();
+    const std::size_t assets = returns.size2();
+    std::vector<double> means = meanReturns(returns);
+
+    boost::numeric::ublas::matrix<double> covariance(assets, assets);
+    for (std::size_t i = 0; i < assets; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            double sum = 0.0;
+            for (std::size_t t = 0; t < periods; ++t) {
+                sum += (returns(t, i) - means[i]) * (returns(t, j) - means[j]);
+            }
+            covariance(i, j) = covariance(j, i) = sum / static_cast<double>(periods - 1);
+        }
+    }
+    return covariance;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef DATA_LOADER_HPP
+#define DATA_LOADER_HPP
+
+#include <string>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for returns and covariance
+
+/**
+ * @class DataLoader
+ * @brief Reads the CSV market data shipped in data/ into ublas matrices.
+ *
+ * Two layouts are supported: return histories (header row of asset names, one row of returns per
+ * period) and covariance matrices (header row plus a leading label column, as written by
+ * data/covariance.py).
+ */
+class DataLoader {
+public:
+    /**
+     * @brief Loads a return history with one row per period and one column per asset.
+     *
+     * @param path Path of a CSV file whose first row holds the asset names.
+     * @return Periods x assets matrix of returns.
+     * @throws std::runtime_error if the file cannot be read, a cell is not a number or its rows have different lengths.
+     */
+    static boost::numeric::ublas::matrix<double> loadReturns(const std::string& path);
+
+    /**
+     * @brief Loads a square covariance matrix with a header row and a label column.
+     *
+     * @param path Path of the CSV file.
+     * @return Assets x assets covariance matrix.
+     * @throws std::runtime_error if the file cannot be read, a cell outside the label column is not a number or
+     *         the matrix is not square.
+     */
+    static boost::numeric::ublas::matrix<double> loadCovariance(const std::string& path);
+
+    /**
+     * @brief Column means of a return history.
+     */
+    static std::vector<double> meanReturns(const boost::numeric::ublas::matrix<double>& returns);
+
+    /**
+     * @brief Unbiased sample covariance of a return history (columns are assets).
+     *
+     * @throws std::invalid_argument if fewer than two periods are given.
+     */
+    static boost::numeric::ublas::matrix<double> sampleCovariance(const boost::numeric::ublas::matrix<double>& returns);
+
+private:
+    /**
+     * @brief Parses every data row, skipping the header row and, if labelColumn is set, the first cell of each row.
+     *
+     * @throws std::runtime_error naming the row and column of the first cell that is not a number.
+     */
+    static std::vector<std::vector<double>> readRows(const std::string& path, bool labelColumn);
+};
+
+#endif // DATA_LOADER_HPP
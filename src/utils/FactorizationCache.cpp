@@ -0,0 +1,69 @@
+#include "FactorizationCache.hpp"
+#include "Instrumentation.hpp"
+#include "LinearAlgebra.hpp"
+#include <stdexcept>
+
+FactorizationCache::FactorizationCache(int numThreads)
+    : num_threads(numThreads), factorization_count(0), current(std::make_shared<const Snapshot>()) {}
+
+void FactorizationCache::setCovariance(const boost::numeric::ublas::matrix<double>& covariance) {
+    if (covariance.size1() != covariance.size2()) {
+        throw std::invalid_argument("Covariance matrix must be square.");
+    }
+    auto next = std::make_shared<Snapshot>();
+    next->dimension = covariance.size1();
+    next->covariance.assign(covariance.data().begin(), covariance.data().end());
+    std::lock_guard<std::mutex> lock(factor_mutex);
+    next->version = current->version + 1;
+    current = std::move(next);
+}
+
+std::shared_ptr<const FactorizationCache::Snapshot> FactorizationCache::snapshot(bool withFactor) {
+    std::lock_guard<std::mutex> lock(factor_mutex);
+    if (withFactor) {
+        refreshFactor();
+    }
+    return current;
+}
+
+std::uint64_t FactorizationCache::version() const {
+    std::lock_guard<std::mutex> lock(factor_mutex);
+    return current->version;
+}
+
+std::size_t FactorizationCache::size() const {
+    std::lock_guard<std::mutex> lock(factor_mutex);
+    return current->dimension;
+}
+
+std::vector<double> FactorizationCache::covariance() const {
+    std::lock_guard<std::mutex> lock(factor_mutex);
+    return current->covariance;
+}
+
+std::size_t FactorizationCache::factorizations() const {
+    std::lock_guard<std::mutex> lock(factor_mutex);
+    return factorization_count;
+}
+
+void FactorizationCache::refreshFactor() {
+    if (current->factor.empty() && current->dimension > 0) {
+        QPO_SCOPED_TIMER("FactorizationCache::cholesky");
+        auto next = std::make_shared<Snapshot>(*current);
+        next->factor = next->covariance;
+        if (!LinearAlgebra::cholesky(next->factor.data(), next->dimension, num_threads)) {
+            throw std::invalid_argument("Covariance matrix must be positive definite.");
+        }
+        current = std::move(next);
+        ++factorization_count;
+    }
+}
+
+std::vector<double> FactorizationCache::cholesky() {
+    return snapshot(true)->factor;
+}
+
+void FactorizationCache::solve(double* b) {
+    const std::shared_ptr<const Snapshot> state = snapshot(true);
+    LinearAlgebra::choleskySolve(state->factor.data(), state->dimension, b);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#ifndef FACTORIZATION_CACHE_HPP
+#define FACTORIZATION_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for the covariance
+
+/**
+ * @class FactorizationCache
+ * @brief Owns a covariance matrix together with its lazily computed Cholesky factor.
+ *
+ * Every call to setCovariance bumps a version number. The O(n^3) factorization is computed on the first
+ * request after a change and reused until the next one, so solvers that only change their other inputs
+ * (risk budgets, views, confidences) between calls never refactorize. Solvers may key their own warm
+ * state on version().
+ *
+ * Every member function takes the internal lock, so one cache can be shared by concurrent solvers while
+ * another thread replaces the covariance. A solver that needs several of version, covariance and factor
+ * should take one snapshot() and use only that, since a setCovariance may land between two separate calls.
+ */
+class FactorizationCache {
+public:
+    /**
+     * @brief Constructor for the FactorizationCache class.
+     *
+     * @param numThreads Threads used by the factorization, 0 to use every hardware thread.
+     */
+    explicit FactorizationCache(int numThreads = 0);
+
+    /**
+     * @brief Immutable view of one covariance version.
+     */
+    struct Snapshot {
+        std::uint64_t version = 0;      ///< Version of the covariance; 0 before the first setCovariance.
+        std::size_t dimension = 0;      ///< Number of assets.
+        std::vector<double> covariance; ///< Covariance, row-major.
+        std::vector<double> factor;     ///< Lower Cholesky factor, row-major; empty unless requested.
+    };
+
+    /**
+     * @brief Consistent view of the current covariance, shared rather than copied.
+     *
+     * @param withFactor Also provide the Cholesky factor, computed on first request after a change.
+     * @throws std::invalid_argument if the factor is requested and the covariance is not positive definite.
+     */
+    std::shared_ptr<const Snapshot> snapshot(bool withFactor = false);
+
+    /**
+     * @brief Replaces the covariance matrix and invalidates the cached factor.
+     *
+     * @throws std::invalid_argument if the matrix is not square.
+     */
+    void setCovariance(const boost::numeric::ublas::matrix<double>& covariance);
+
+    /**
+     * @brief Version of the current covariance; 0 before the first setCovariance.
+     */
+    std::uint64_t version() const;
+
+    /**
+     * @brief Dimension of the covariance matrix.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Snapshot of the covariance matrix, row-major.
+     */
+    std::vector<double> covariance() const;
+
+    /**
+     * @brief Snapshot of the lower Cholesky factor of the covariance, row-major, computed on first use after a change.
+     *
+     * @throws std::invalid_argument if the covariance is not positive definite.
+     */
+    std::vector<double> cholesky();
+
+    /**
+     * @brief Solves Sigma * x = b in place with the factor of the current snapshot.
+     *
+     * @throws std::invalid_argument if the covariance is not positive definite.
+     */
+    void solve(double* b);
+
+    /**
+     * @brief Number of factorizations performed so far (for diagnostics).
+     */
+    std::size_t factorizations() const;
+
+private:
+    int num_threads;                        ///< Threads used by the factorization.
+    std::size_t factorization_count;        ///< Factorizations performed.
+    std::shared_ptr<const Snapshot> current; ///< Current covariance and, once computed, its factor.
+    mutable std::mutex factor_mutex;        ///< Guards every member above.
+
+    /**
+     * @brief Publishes a snapshot with the factor if the current one lacks it; the lock must be held.
+     */
+    void refreshFactor();
+};
+
+#endif // FACTORIZATION_CACHE_HPP
@@ -0,0 +1,276 @@
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t RING_CAPACITY = 1u << 13; // Events per thread between two flushes
+constexpr std::uint64_t RING_MASK = RING_CAPACITY - 1;
+
+// Single-producer / single-consumer ring owned by one recording thread
+struct ThreadBuffer {
+    std::unique_ptr<Instrumentation::Event[]> events{new Instrumentation::Event[RING_CAPACITY]};
+    std::atomic<std::uint64_t> head{0}; // Written by the owning thread
+    std::atomic<std::uint64_t> tail{0}; // Written by the consumer
+    std::atomic<bool> retired{false};   // Set once the owning thread has exited
+    std::uint32_t thread = 0;
+};
+
+// Marks the calling thread's buffer retired when the thread exits, so that the next drain recycles it
+struct BufferOwner {
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~BufferOwner() {
+        if (buffer) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+struct Registry {
+    std::mutex buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; // Buffers of live threads and not yet drained exits
+    std::vector<std::shared_ptr<ThreadBuffer>> spare;   // Drained buffers of exited threads, ready for reuse
+    std::uint32_t nextThread = 0;
+
+    std::mutex flushMutex;
+    std::ofstream log;
+    std::deque<Instrumentation::Event> history;
+    std::size_t historyLimit = 1u << 20;
+    std::atomic<std::uint64_t> dropped{0};
+
+    std::mutex dumpMutex;
+    std::condition_variable dumpSignal;
+    std::thread dumpThread;
+    bool dumpRunning = false;
+
+    ~Registry() {
+        Instrumentation::stopPeriodicDump();
+    }
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer& localBuffer() {
+    thread_local BufferOwner owner;
+    if (!owner.buffer) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.buffersMutex);
+        if (reg.spare.empty()) {
+            owner.buffer = std::make_shared<ThreadBuffer>();
+        } else {
+            owner.buffer = std::move(reg.spare.back());
+            reg.spare.pop_back();
+            owner.buffer->head.store(0, std::memory_order_relaxed);
+            owner.buffer->tail.store(0, std::memory_order_relaxed);
+            owner.buffer->retired.store(false, std::memory_order_relaxed);
+        }
+        owner.buffer->thread = reg.nextThread++;
+        reg.buffers.push_back(owner.buffer); // The registry keeps the buffer until its last events are drained
+    }
+    return *owner.buffer;
+}
+
+const char* typeName(Instrumentation::EventType type) {
+    switch (type) {
+    case Instrumentation::EventType::Timer: return "timer";
+    case Instrumentation::EventType::Counter: return "counter";
+    default: return "instant";
+    }
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+}
+
+// Drains every ring buffer and moves those of exited threads to the spare list; the caller must hold flushMutex
+template <typename Sink>
+void drainBuffers(Registry& reg, Sink sink) {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(reg.buffersMutex);
+        buffers = reg.buffers;
+    }
+    std::vector<ThreadBuffer*> drained;
+    for (const auto& buffer : buffers) {
+        // Read retired before head: a retired owner has published its final head
+        bool retired = buffer->retired.load(std::memory_order_acquire);
+        std::uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (std::uint64_t i = tail; i < head; ++i) {
+            sink(buffer->events[i & RING_MASK]);
+        }
+        buffer->tail.store(head, std::memory_order_release);
+        if (retired) {
+            drained.push_back(buffer.get());
+        }
+    }
+    if (!drained.empty()) {
+        std::lock_guard<std::mutex> lock(reg.buffersMutex);
+        auto dead = std::stable_partition(reg.buffers.begin(), reg.buffers.end(), [&drained](const auto& buffer) {
+            return std::find(drained.begin(), drained.end(), buffer.get()) == drained.end();
+        });
+        std::move(dead, reg.buffers.end(), std::back_inserter(reg.spare));
+        reg.buffers.erase(dead, reg.buffers.end());
+    }
+}
+
+} // namespace
+
+std::chrono::steady_clock::time_point Instrumentation::epoch() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+void Instrumentation::record(EventType type, const char* name, std::uint64_t startNs, std::uint64_t durationNs, double value) {
+    ThreadBuffer& buffer = localBuffer();
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.events[head & RING_MASK] = Event{name, startNs, durationNs, value, buffer.thread, type};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Instrumentation::flush() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.flushMutex);
+    drainBuffers(reg, [&reg](const Event& event) {
+        if (reg.log.is_open()) {
+            reg.log << std::fixed << std::setprecision(6) << event.startNs * 1e-9 << " thread=" << event.thread
+                    << ' ' << typeName(event.type) << ' ' << event.name;
+            if (event.type == EventType::Timer) {
+                reg.log << " duration_us=" << std::setprecision(3) << event.durationNs * 1e-3;
+            } else if (event.type == EventType::Counter) {
+                reg.log << " value=" << std::defaultfloat << std::setprecision(10) << event.value;
+            }
+            reg.log << '\n';
+        }
+        reg.history.push_back(event);
+        if (reg.history.size() > reg.historyLimit) {
+            reg.history.pop_front();
+        }
+    });
+    if (reg.log.is_open()) {
+        reg.log.flush();
+    }
+}
+
+void Instrumentation::startPeriodicDump(const std::string& logPath, int intervalMs) {
+    setLogFile(logPath);
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.dumpMutex);
+    if (reg.dumpRunning) {
+        return;
+    }
+    reg.dumpRunning = true;
+    reg.dumpThread = std::thread([&reg, intervalMs]() {
+        std::unique_lock<std::mutex> dumpLock(reg.dumpMutex);
+        while (reg.dumpRunning) {
+            reg.dumpSignal.wait_for(dumpLock, std::chrono::milliseconds(intervalMs));
+            dumpLock.unlock();
+            flush();
+            dumpLock.lock();
+        }
+    });
+}
+
+void Instrumentation::stopPeriodicDump() {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.dumpMutex);
+        if (!reg.dumpRunning) {
+            return;
+        }
+        reg.dumpRunning = false;
+    }
+    reg.dumpSignal.notify_all();
+    reg.dumpThread.join();
+    flush();
+}
+
+void Instrumentation::setLogFile(const std::string& logPath) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.flushMutex);
+    std::filesystem::path path(logPath);
+    if (path.has_parent_path()) {
+        std::error_code ignored;
+        std::filesystem::create_directories(path.parent_path(), ignored);
+    }
+    if (reg.log.is_open()) {
+        reg.log.close();
+    }
+    reg.log.open(logPath, std::ios::app);
+}
+
+void Instrumentation::setTraceHistoryLimit(std::size_t maxEvents) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.flushMutex);
+    reg.historyLimit = maxEvents;
+    while (reg.history.size() > reg.historyLimit) {
+        reg.history.pop_front();
+    }
+}
+
+bool Instrumentation::exportChromeTrace(const std::string& path) {
+    flush();
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.flushMutex);
+    out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (const Event& event : reg.history) {
+        out << (first ? "  " : ",\n  ") << "{\"name\": \"";
+        writeEscaped(out, event.name);
+        out << "\", \"pid\": 1, \"tid\": " << event.thread << ", \"ts\": " << event.startNs * 1e-3;
+        switch (event.type) {
+        case EventType::Timer:
+            out << ", \"ph\": \"X\", \"dur\": " << event.durationNs * 1e-3;
+            break;
+        case EventType::Counter:
+            out << ", \"ph\": \"C\", \"args\": {\"value\": " << std::defaultfloat << std::setprecision(10)
+                << event.value << std::fixed << std::setprecision(3) << "}";
+            break;
+        case EventType::Instant:
+            out << ", \"ph\": \"i\", \"s\": \"t\"";
+            break;
+        }
+        out << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+std::uint64_t Instrumentation::droppedEvents() {
+    return registry().dropped.load(std::memory_order_relaxed);
+}
+
+void Instrumentation::reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.flushMutex);
+    drainBuffers(reg, [](const Event&) {});
+    reg.history.clear();
+    reg.dropped.store(0, std::memory_order_relaxed);
+}
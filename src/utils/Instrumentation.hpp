@@ -0,0 +1,159 @@
+#pragma once
+
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Compile-time instrumentation level.
+ *
+ *  - 0: every QPO_* macro compiles to nothing.
+ *  - 1: scoped timers and counters (default).
+ *  - 2: additionally records per-iteration trace values and messages from solver hot loops.
+ */
+#ifndef QPO_INSTRUMENTATION_LEVEL
+#define QPO_INSTRUMENTATION_LEVEL 1
+#endif
+
+/**
+ * @class Instrumentation
+ * @brief Low-overhead timers, counters and trace events for the solver hot paths.
+ *
+ * Events are appended to a fixed-size ring buffer owned by the recording thread, so recording never
+ * takes a lock and never allocates after the thread's first event. A single consumer (flush(), usually
+ * driven by the periodic dump thread) drains every ring buffer, appends a line per event to the
+ * performance log and keeps a bounded history that can be exported as a Chrome trace
+ * (chrome://tracing or Perfetto). When a ring buffer is full, new events are dropped and counted
+ * rather than blocking the solver. When a thread exits, the next flush drains its buffer and keeps it for
+ * reuse by a later thread, so short-lived threads do not accumulate buffers.
+ *
+ * Event names must be string literals (or otherwise outlive the process), since only the pointer is stored.
+ */
+class Instrumentation {
+public:
+    /// Kind of a recorded event.
+    enum class EventType : std::uint8_t {
+        Timer,    ///< A completed scoped timer (start and duration).
+        Counter,  ///< A sampled counter or traced value.
+        Instant   ///< A point-in-time marker.
+    };
+
+    /// A single recorded event.
+    struct Event {
+        const char* name;          ///< Event name (string literal).
+        std::uint64_t startNs;     ///< Start time in nanoseconds since the process epoch.
+        std::uint64_t durationNs;  ///< Duration in nanoseconds (timers only).
+        double value;              ///< Sampled value (counters only).
+        std::uint32_t thread;      ///< Sequential id of the recording thread.
+        EventType type;            ///< Kind of event.
+    };
+
+    /**
+     * @class ScopedTimer
+     * @brief Records a Timer event covering its own lifetime.
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(const char* name) : name(name), startNs(now()) {}
+        ~ScopedTimer() { record(EventType::Timer, name, startNs, now() - startNs, 0.0); }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        const char* name;
+        std::uint64_t startNs;
+    };
+
+    /// Nanoseconds elapsed since the process-wide instrumentation epoch.
+    static std::uint64_t now() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch()).count());
+    }
+
+    /**
+     * @brief Appends an event to the calling thread's ring buffer.
+     */
+    static void record(EventType type, const char* name, std::uint64_t startNs, std::uint64_t durationNs, double value);
+
+    /// Records a Counter event with the given value at the current time.
+    static void counter(const char* name, double value) { record(EventType::Counter, name, now(), 0, value); }
+
+    /// Records an Instant event at the current time.
+    static void instant(const char* name) { record(EventType::Instant, name, now(), 0, 0.0); }
+
+    /**
+     * @brief Drains every thread's ring buffer into the log file and the trace history.
+     *
+     * Safe to call from any thread; concurrent callers are serialised.
+     */
+    static void flush();
+
+    /**
+     * @brief Starts a background thread that calls flush() at a fixed interval.
+     *
+     * @param logPath File the drained events are appended to, created (with its directory) if missing.
+     * @param intervalMs Interval between dumps in milliseconds.
+     */
+    static void startPeriodicDump(const std::string& logPath = "logs/performance_logs.log", int intervalMs = 1000);
+
+    /**
+     * @brief Stops the periodic dump thread, if running, after a final flush.
+     */
+    static void stopPeriodicDump();
+
+    /**
+     * @brief Sets the log file used by flush() without starting the dump thread.
+     */
+    static void setLogFile(const std::string& logPath);
+
+    /**
+     * @brief Limits how many drained events are kept for the Chrome trace export (oldest are discarded).
+     */
+    static void setTraceHistoryLimit(std::size_t maxEvents);
+
+    /**
+     * @brief Flushes and writes the retained history in Chrome trace event JSON format.
+     *
+     * @param path Output file.
+     * @return true if the file was written.
+     */
+    static bool exportChromeTrace(const std::string& path);
+
+    /**
+     * @brief Number of events dropped because a ring buffer was full.
+     */
+    static std::uint64_t droppedEvents();
+
+    /**
+     * @brief Discards all buffered events and the trace history.
+     */
+    static void reset();
+
+private:
+    static std::chrono::steady_clock::time_point epoch();
+};
+
+#define QPO_INSTRUMENTATION_CONCAT_INNER(a, b) a##b
+#define QPO_INSTRUMENTATION_CONCAT(a, b) QPO_INSTRUMENTATION_CONCAT_INNER(a, b)
+
+#if QPO_INSTRUMENTATION_LEVEL >= 1
+#define QPO_SCOPED_TIMER(name) Instrumentation::ScopedTimer QPO_INSTRUMENTATION_CONCAT(qpo_scoped_timer_, __LINE__)(name)
+#define QPO_COUNTER(name, value) Instrumentation::counter(name, static_cast<double>(value))
+#else
+#define QPO_SCOPED_TIMER(name) ((void)0)
+#define QPO_COUNTER(name, value) ((void)0)
+#endif
+
+#if QPO_INSTRUMENTATION_LEVEL >= 2
+#define QPO_TRACE_VALUE(name, value) Instrumentation::counter(name, static_cast<double>(value))
+#define QPO_TRACE_MESSAGE(name) Instrumentation::instant(name)
+#else
+#define QPO_TRACE_VALUE(name, value) ((void)0)
+#define QPO_TRACE_MESSAGE(name) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_HPP
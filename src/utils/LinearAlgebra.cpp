@@ -0,0 +1,170 @@
+#include "LinearAlgebra.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t BLOCK_K = 128;  // Depth of the B panel kept in cache
+constexpr std::size_t BLOCK_N = 512;  // Width of the B panel kept in cache
+constexpr std::size_t CHOLESKY_BLOCK = 96;
+
+// C[rows, cols] += A[rows, depth] * B[depth, cols] on one cache block, four rows of C at a time
+template <typename T>
+void gemmBlock(std::size_t rows, std::size_t cols, std::size_t depth,
+               const T* A, std::size_t lda, const T* B, std::size_t ldb, T* C, std::size_t ldc) {
+    std::size_t i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        T* c0 = C + i * ldc;
+        T* c1 = c0 + ldc;
+        T* c2 = c1 + ldc;
+        T* c3 = c2 + ldc;
+        for (std::size_t p = 0; p < depth; ++p) {
+            const T a0 = A[i * lda + p];
+            const T a1 = A[(i + 1) * lda + p];
+            const T a2 = A[(i + 2) * lda + p];
+            const T a3 = A[(i + 3) * lda + p];
+            const T* b = B + p * ldb;
+            for (std::size_t j = 0; j < cols; ++j) {
+                const T bj = b[j];
+                c0[j] += a0 * bj;
+                c1[j] += a1 * bj;
+                c2[j] += a2 * bj;
+                c3[j] += a3 * bj;
+            }
+        }
+    }
+    for (; i < rows; ++i) {
+        T* c = C + i * ldc;
+        for (std::size_t p = 0; p < depth; ++p) {
+            const T a = A[i * lda + p];
+            const T* b = B + p * ldb;
+            for (std::size_t j = 0; j < cols; ++j) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+template <typename T>
+void gemmSerial(std::size_t m, std::size_t n, std::size_t k,
+                const T* A, std::size_t lda, const T* B, std::size_t ldb, T* C, std::size_t ldc) {
+    for (std::size_t jj = 0; jj < n; jj += BLOCK_N) {
+        std::size_t cols = std::min(BLOCK_N, n - jj);
+        for (std::size_t pp = 0; pp < k; pp += BLOCK_K) {
+            std::size_t depth = std::min(BLOCK_K, k - pp);
+            gemmBlock(m, cols, depth, A + pp, lda, B + pp * ldb + jj, ldb, C + jj, ldc);
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+void LinearAlgebra::gemm(std::size_t m, std::size_t n, std::size_t k,
+                         const T* A, std::size_t lda,
+                         const T* B, std::size_t ldb,
+                         T* C, std::size_t ldc,
+                         bool accumulate, int numThreads) {
+    Parallel::forRange(0, m, numThreads, [&](std::size_t lo, std::size_t hi, int) {
+        if (!accumulate) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                std::fill(C + i * ldc, C + i * ldc + n, T(0));
+            }
+        }
+        gemmSerial(hi - lo, n, k, A + lo * lda, lda, B, ldb, C + lo * ldc, ldc);
+    });
+}
+
+template void LinearAlgebra::gemm<float>(std::size_t, std::size_t, std::size_t, const float*, std::size_t,
+                                         const float*, std::size_t, float*, std::size_t, bool, int);
+template void LinearAlgebra::gemm<double>(std::size_t, std::size_t, std::size_t, const double*, std::size_t,
+                                          const double*, std::size_t, double*, std::size_t, bool, int);
+
+bool LinearAlgebra::cholesky(double* a, std::size_t n, int numThreads) {
+    std::vector<double> panel;
+    std::vector<double> panelTransposed;
+
+    for (std::size_t k0 = 0; k0 < n; k0 += CHOLESKY_BLOCK) {
+        std::size_t nb = std::min(CHOLESKY_BLOCK, n - k0);
+        std::size_t k1 = k0 + nb;
+
+        // Unblocked factorization of the diagonal block
+        for (std::size_t j = k0; j < k1; ++j) {
+            double d = a[j * n + j];
+            for (std::size_t p = k0; p < j; ++p) d -= a[j * n + p] * a[j * n + p];
+            if (!(d > 0.0)) {
+                return false;
+            }
+            d = std::sqrt(d);
+            a[j * n + j] = d;
+            for (std::size_t i = j + 1; i < k1; ++i) {
+                double s = a[i * n + j];
+                for (std::size_t p = k0; p < j; ++p) s -= a[i * n + p] * a[j * n + p];
+                a[i * n + j] = s / d;
+            }
+        }
+
+        std::size_t rest = n - k1;
+        if (rest == 0) {
+            break;
+        }
+
+        // Panel below the diagonal block: L21 = A21 * L11^-T, one independent row at a time
+        Parallel::forRange(k1, n, numThreads, [&](std::size_t lo, std::size_t hi, int) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                for (std::size_t j = k0; j < k1; ++j) {
+                    double s = a[i * n + j];
+                    for (std::size_t p = k0; p < j; ++p) s -= a[i * n + p] * a[j * n + p];
+                    a[i * n + j] = s / a[j * n + j];
+                }
+            }
+        });
+
+        // Trailing update A22 -= L21 * L21^T, restricted to the lower triangle row block by row block
+        panel.assign(rest * nb, 0.0);
+        panelTransposed.assign(nb * rest, 0.0);
+        for (std::size_t i = 0; i < rest; ++i) {
+            for (std::size_t p = 0; p < nb; ++p) {
+                double v = a[(k1 + i) * n + k0 + p];
+                panel[i * nb + p] = v;
+                panelTransposed[p * rest + i] = -v;
+            }
+        }
+        Parallel::forRange(0, (rest + CHOLESKY_BLOCK - 1) / CHOLESKY_BLOCK, numThreads, [&](std::size_t lo, std::size_t hi, int) {
+            for (std::size_t b = lo; b < hi; ++b) {
+                std::size_t r0 = b * CHOLESKY_BLOCK;
+                std::size_t r1 = std::min(rest, r0 + CHOLESKY_BLOCK);
+                gemmSerial(r1 - r0, r1, nb, panel.data() + r0 * nb, nb, panelTransposed.data(), rest,
+                           a + (k1 + r0) * n + k1, n);
+            }
+        });
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        std::fill(a + i * n + i + 1, a + (i + 1) * n, 0.0);
+    }
+    return true;
+}
+
+void LinearAlgebra::solveLower(const double* L, std::size_t n, double* b) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double s = b[i];
+        for (std::size_t p = 0; p < i; ++p) s -= L[i * n + p] * b[p];
+        b[i] = s / L[i * n + i];
+    }
+}
+
+void LinearAlgebra::solveLowerTransposed(const double* L, std::size_t n, double* b) {
+    for (std::size_t i = n; i-- > 0;) {
+        b[i] /= L[i * n + i];
+        const double x = b[i];
+        for (std::size_t p = 0; p < i; ++p) b[p] -= L[i * n + p] * x; // Column i of L^T is row i of L
+    }
+}
+
+void LinearAlgebra::choleskySolve(const double* L, std::size_t n, double* b) {
+    solveLower(L, n, b);
+    solveLowerTransposed(L, n, b);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#ifndef LINEAR_ALGEBRA_HPP
+#define LINEAR_ALGEBRA_HPP
+
+#include <cstddef>
+
+/**
+ * @class LinearAlgebra
+ * @brief Dense kernels on row-major buffers used by the risk, evaluation and factorization code.
+ *
+ * The kernels operate on raw row-major storage so they can be applied directly to the contiguous
+ * data of a boost::numeric::ublas::matrix (row-major by default) or to std::vector scratch buffers
+ * without copying.
+ */
+class LinearAlgebra {
+public:
+    /**
+     * @brief Cache-blocked matrix product C = A * B, or C += A * B when accumulating.
+     *
+     * A is m x k, B is k x n and C is m x n, all row-major with the given leading dimensions.
+     * Rows of C are distributed over the requested number of threads.
+     *
+     * @tparam T float or double.
+     * @param accumulate Add to C instead of overwriting it.
+     * @param numThreads Number of threads, 0 to use every hardware thread.
+     */
+    template <typename T>
+    static void gemm(std::size_t m, std::size_t n, std::size_t k,
+                     const T* A, std::size_t lda,
+                     const T* B, std::size_t ldb,
+                     T* C, std::size_t ldc,
+                     bool accumulate = false, int numThreads = 1);
+
+    /**
+     * @brief In-place blocked Cholesky factorization A = L * L^T of a symmetric positive-definite matrix.
+     *
+     * On success the lower triangle of a holds L and the strict upper triangle is zeroed.
+     * The trailing-matrix updates are performed as multithreaded GEMMs.
+     *
+     * @param a n x n row-major matrix; only the lower triangle is read.
+     * @param n Dimension of the matrix.
+     * @param numThreads Number of threads, 0 to use every hardware thread.
+     * @return false if the matrix is not positive definite (a is then left partially factorized).
+     */
+    static bool cholesky(double* a, std::size_t n, int numThreads = 0);
+
+    /**
+     * @brief Solves L * x = b in place for a lower-triangular L.
+     */
+    static void solveLower(const double* L, std::size_t n, double* b);
+
+    /**
+     * @brief Solves L^T * x = b in place for a lower-triangular L.
+     */
+    static void solveLowerTransposed(const double* L, std::size_t n, double* b);
+
+    /**
+     * @brief Solves (L * L^T) * x = b in place given the Cholesky factor L.
+     */
+    static void choleskySolve(const double* L, std::size_t n, double* b);
+};
+
+#endif // LINEAR_ALGEBRA_HPP
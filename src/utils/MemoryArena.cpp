@@ -0,0 +1,189 @@
+#include "MemoryArena.hpp"
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{0};
+std::atomic<std::uint64_t> releases{0};
+std::atomic<std::uint64_t> bytesInUse{0};
+std::atomic<std::uint64_t> peakBytes{0};
+std::atomic<std::uint64_t> hugeBytesInUse{0};
+std::atomic<std::uint64_t> reuses{0};
+
+std::size_t roundUp(std::size_t value, std::size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+void recordAllocation(std::size_t bytes) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::uint64_t inUse = bytesInUse.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytes.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+    }
+    QPO_COUNTER("HugePageAllocator::allocate.bytes", bytes);
+}
+
+#if defined(__linux__)
+// Maps bytes rounded to whole huge pages at a huge-page boundary, trimming the over-mapped head and tail
+void* mapHugePages(std::size_t bytes) {
+    const std::size_t span = bytes + HugePageAllocator::hugePageBytes;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = roundUp(start, HugePageAllocator::hugePageBytes);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    const std::size_t tail = start + span - (aligned + bytes);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE); // Advisory; 4 KB pages if THP is off
+#endif
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+} // namespace
+
+HugePageAllocator::Block HugePageAllocator::allocate(std::size_t bytes) {
+    Block block;
+    if (bytes == 0) {
+        return block;
+    }
+    if (bytes > std::numeric_limits<std::size_t>::max() - hugePageBytes) {
+        throw std::bad_alloc(); // Rounding up to whole pages would wrap around
+    }
+#if defined(__linux__)
+    if (bytes >= largeBlockBytes) {
+        const std::size_t rounded = roundUp(bytes, hugePageBytes);
+        if (void* data = mapHugePages(rounded)) {
+            block.data = data;
+            block.bytes = rounded;
+            block.mapped = true;
+            block.hugePages = true;
+            hugeBytesInUse.fetch_add(rounded, std::memory_order_relaxed);
+            recordAllocation(rounded);
+            return block;
+        }
+    }
+#endif
+    // Small blocks, platforms without mmap, and mapping failures use the aligned heap
+    block.bytes = roundUp(bytes, alignment);
+    block.data = ::operator new(block.bytes, std::align_val_t(alignment));
+    recordAllocation(block.bytes);
+    return block;
+}
+
+void HugePageAllocator::release(Block& block) {
+    if (block.data == nullptr) {
+        return;
+    }
+#if defined(__linux__)
+    if (block.mapped) {
+        munmap(block.data, block.bytes);
+    } else
+#endif
+    {
+        ::operator delete(block.data, std::align_val_t(alignment));
+    }
+    if (block.hugePages) {
+        hugeBytesInUse.fetch_sub(block.bytes, std::memory_order_relaxed);
+    }
+    bytesInUse.fetch_sub(block.bytes, std::memory_order_relaxed);
+    releases.fetch_add(1, std::memory_order_relaxed);
+    block = Block();
+}
+
+HugePageAllocator::Stats HugePageAllocator::stats() {
+    Stats stats;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.releases = releases.load(std::memory_order_relaxed);
+    stats.bytesInUse = bytesInUse.load(std::memory_order_relaxed);
+    stats.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    stats.hugePageBytesInUse = hugeBytesInUse.load(std::memory_order_relaxed);
+    stats.reuses = reuses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void HugePageAllocator::recordReuse() {
+    reuses.fetch_add(1, std::memory_order_relaxed);
+}
+
+MemoryArena::MemoryArena(std::size_t blockBytes)
+    : block_bytes(std::max<std::size_t>(blockBytes, HugePageAllocator::alignment)), current(0), offset(0) {}
+
+MemoryArena::~MemoryArena() {
+    for (HugePageAllocator::Block& block : blocks) {
+        HugePageAllocator::release(block);
+    }
+}
+
+void* MemoryArena::allocate(std::size_t bytes, std::size_t alignment) {
+    if (bytes > std::numeric_limits<std::size_t>::max() / 2 - alignment) {
+        throw std::bad_alloc(); // No block can hold it, and growing the block size would wrap around
+    }
+    // Try the current block, then any later block kept from a previous round
+    for (; current < blocks.size(); ++current, offset = 0) {
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(blocks[current].data);
+        const std::size_t start = roundUp(base + offset, alignment) - base;
+        if (start + bytes <= blocks[current].bytes) {
+            offset = start + bytes;
+            HugePageAllocator::recordReuse();
+            return reinterpret_cast<void*>(base + start);
+        }
+    }
+
+    const std::size_t previous = blocks.empty() ? block_bytes / 2 : blocks.back().bytes;
+    blocks.push_back(HugePageAllocator::allocate(std::max(previous * 2, bytes + alignment)));
+    current = blocks.size() - 1;
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(blocks[current].data);
+    const std::size_t start = roundUp(base, alignment) - base;
+    offset = start + bytes;
+    return reinterpret_cast<void*>(base + start);
+}
+
+void MemoryArena::reset() {
+    if (blocks.size() > 1) {
+        const std::size_t total = capacity();
+        for (HugePageAllocator::Block& block : blocks) {
+            HugePageAllocator::release(block);
+        }
+        blocks.clear();
+        blocks.push_back(HugePageAllocator::allocate(total));
+    }
+    current = 0;
+    offset = 0;
+}
+
+std::size_t MemoryArena::bytesUsed() const {
+    std::size_t used = 0;
+    for (std::size_t b = 0; b < current && b < blocks.size(); ++b) {
+        used += blocks[b].bytes;
+    }
+    return current < blocks.size() ? used + offset : used;
+}
+
+std::size_t MemoryArena::capacity() const {
+    std::size_t total = 0;
+    for (const HugePageAllocator::Block& block : blocks) {
+        total += block.bytes;
+    }
+    return total;
+}
+
+MemoryArena& MemoryArena::threadLocal() {
+    thread_local MemoryArena arena;
+    return arena;
+}
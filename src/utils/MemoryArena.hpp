@@ -0,0 +1,221 @@
+#pragma once
+
+#ifndef MEMORY_ARENA_HPP
+#define MEMORY_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @class HugePageAllocator
+ * @brief Source of large, aligned blocks for simulator state and solver scratch space.
+ *
+ * Blocks of at least largeBlockBytes are mapped directly (mmap on Linux), aligned to a 2 MB boundary and
+ * advised as transparent huge pages, so a multi-gigabyte state vector needs a few thousand TLB entries
+ * instead of a million. Smaller blocks, and every block on platforms without mmap, come from the aligned
+ * operator new. Process-wide counters record every block handed out.
+ */
+class HugePageAllocator {
+public:
+    static constexpr std::size_t hugePageBytes = std::size_t(2) << 20;   ///< Transparent huge page size.
+    static constexpr std::size_t largeBlockBytes = std::size_t(1) << 20; ///< Blocks from this size on are mapped.
+    static constexpr std::size_t alignment = 64;                         ///< Minimum alignment of every block.
+
+    /**
+     * @brief A block obtained from allocate.
+     */
+    struct Block {
+        void* data = nullptr;   ///< Start of the usable memory.
+        std::size_t bytes = 0;  ///< Usable size in bytes.
+        bool mapped = false;    ///< True if the block was mapped rather than taken from the heap.
+        bool hugePages = false; ///< True if huge pages were requested for the block.
+    };
+
+    /**
+     * @brief Process-wide allocation counters.
+     */
+    struct Stats {
+        std::uint64_t allocations = 0;   ///< Blocks allocated.
+        std::uint64_t releases = 0;      ///< Blocks released.
+        std::uint64_t bytesInUse = 0;    ///< Bytes currently held in blocks.
+        std::uint64_t peakBytes = 0;     ///< Largest bytesInUse seen.
+        std::uint64_t hugePageBytesInUse = 0; ///< Bytes currently held in blocks advised as huge pages.
+        std::uint64_t reuses = 0;        ///< Buffer and arena requests served without a new block.
+    };
+
+    /**
+     * @brief Allocates an uninitialised block of at least the given size.
+     *
+     * @throws std::bad_alloc if the memory cannot be obtained.
+     */
+    static Block allocate(std::size_t bytes);
+
+    /**
+     * @brief Returns a block to the system and clears it.
+     */
+    static void release(Block& block);
+
+    /**
+     * @brief Snapshot of the process-wide counters.
+     */
+    static Stats stats();
+
+    /**
+     * @brief Counts a request that was served from memory already held.
+     */
+    static void recordReuse();
+};
+
+/**
+ * @class StateBuffer
+ * @brief Reusable, aligned, huge-page-backed array for state vectors.
+ *
+ * acquire only allocates when the requested size exceeds the capacity held, so a simulator that keeps
+ * its StateBuffer as a member touches fresh pages once instead of on every optimizer iteration. The
+ * contents are left uninitialised; callers write every element they read.
+ */
+template <typename T>
+class StateBuffer {
+    static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                  "StateBuffer holds trivially copyable elements only");
+
+public:
+    StateBuffer() = default;
+    StateBuffer(const StateBuffer&) = delete;
+    StateBuffer& operator=(const StateBuffer&) = delete;
+    StateBuffer(StateBuffer&& other) noexcept : block(std::exchange(other.block, HugePageAllocator::Block())), count(std::exchange(other.count, 0)) {}
+    StateBuffer& operator=(StateBuffer&& other) noexcept {
+        if (this != &other) {
+            HugePageAllocator::release(block);
+            block = std::exchange(other.block, HugePageAllocator::Block());
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+    ~StateBuffer() { HugePageAllocator::release(block); }
+
+    /**
+     * @brief Resizes the buffer to count elements, reallocating only if the capacity is too small.
+     *
+     * @return Pointer to the (uninitialised) elements.
+     * @throws std::length_error if elements * sizeof(T) does not fit in std::size_t.
+     */
+    T* acquire(std::size_t elements) {
+        if (elements > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::length_error("StateBuffer size overflows std::size_t");
+        }
+        if (elements * sizeof(T) > block.bytes) {
+            HugePageAllocator::release(block);
+            block = HugePageAllocator::allocate(elements * sizeof(T));
+        } else if (elements > 0) {
+            HugePageAllocator::recordReuse();
+        }
+        count = elements;
+        return data();
+    }
+
+    T* data() { return static_cast<T*>(block.data); }
+    const T* data() const { return static_cast<const T*>(block.data); }
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return block.bytes / sizeof(T); }
+    T& operator[](std::size_t i) { return data()[i]; }
+    const T& operator[](std::size_t i) const { return data()[i]; }
+
+private:
+    HugePageAllocator::Block block; ///< Backing memory.
+    std::size_t count = 0;          ///< Elements in use.
+};
+
+/**
+ * @class MemoryArena
+ * @brief Bump allocator for per-call solver scratch space.
+ *
+ * Allocations are carved out of large blocks and never freed individually; reset() makes the whole
+ * arena available again and, if the last round needed several blocks, merges them into one so the next
+ * round fits without allocating. Scope rewinds the arena to where it was when the scope was opened,
+ * which lets nested kernels share the per-thread arena returned by threadLocal().
+ */
+class MemoryArena {
+public:
+    /**
+     * @brief Constructor for the MemoryArena class.
+     *
+     * @param blockBytes Size of the first block; later blocks grow geometrically.
+     */
+    explicit MemoryArena(std::size_t blockBytes = HugePageAllocator::largeBlockBytes);
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+    ~MemoryArena();
+
+    /**
+     * @brief Returns uninitialised memory of the given size and alignment (a power of two).
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = HugePageAllocator::alignment);
+
+    /**
+     * @brief Returns uninitialised storage for count elements of T.
+     *
+     * @throws std::length_error if elements * sizeof(T) does not fit in std::size_t.
+     */
+    template <typename T>
+    T* allocate(std::size_t elements) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destroyed element-wise");
+        if (elements > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::length_error("Arena allocation size overflows std::size_t");
+        }
+        const std::size_t align = alignof(T) > HugePageAllocator::alignment ? alignof(T) : HugePageAllocator::alignment;
+        return static_cast<T*>(allocate(elements * sizeof(T), align));
+    }
+
+    /**
+     * @brief Makes all memory available again, keeping (and merging) the blocks.
+     */
+    void reset();
+
+    /**
+     * @brief Bytes handed out since the last reset (including alignment padding).
+     */
+    std::size_t bytesUsed() const;
+
+    /**
+     * @brief Bytes held in blocks.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * @brief The calling thread's scratch arena.
+     */
+    static MemoryArena& threadLocal();
+
+    /**
+     * @brief Rewinds an arena to its current position when destroyed.
+     */
+    class Scope {
+    public:
+        explicit Scope(MemoryArena& arena) : arena(arena), block(arena.current), offset(arena.offset) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() {
+            arena.current = block;
+            arena.offset = offset;
+        }
+
+    private:
+        MemoryArena& arena;
+        std::size_t block;
+        std::size_t offset;
+    };
+
+private:
+    std::vector<HugePageAllocator::Block> blocks; ///< Blocks in allocation order.
+    std::size_t block_bytes;                      ///< Size of the first block.
+    std::size_t current;                          ///< Block currently carved from.
+    std::size_t offset;                           ///< Next free byte in the current block.
+};
+
+#endif // MEMORY_ARENA_HPP
@@ -0,0 +1,360 @@
+#include "OptimizationService.hpp"
+#include "DataLoader.hpp"
+#include "Instrumentation.hpp"
+#include "../classical_algorithms/GeneticAlgorithm.hpp"
+#include "../classical_algorithms/Optimization.hpp"
+#include "../classical_algorithms/TabuSearch.hpp"
+#include "../quantum_algorithms/QPCA.hpp"
+#include "../quantum_algorithms/QuantumAnnealing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::size_t QUBO_CACHE_SIZE = 16; // Selection QUBOs kept per universe; the least recently used is evicted
+
+// Splits "command arg key=value ..." into positional arguments and options
+void tokenize(const std::string& line, std::vector<std::string>& positional, std::map<std::string, std::string>& options) {
+    std::istringstream stream(line);
+    std::string token;
+    while (stream >> token) {
+        const std::size_t equals = token.find('=');
+        if (equals == std::string::npos) {
+            positional.push_back(token);
+        } else {
+            options[token.substr(0, equals)] = token.substr(equals + 1);
+        }
+    }
+}
+
+std::string option(const std::map<std::string, std::string>& options, const std::string& key, const std::string& fallback) {
+    auto it = options.find(key);
+    return it == options.end() ? fallback : it->second;
+}
+
+// Parses a numeric option, rejecting text that is not entirely a number
+double numberOption(const std::map<std::string, std::string>& options, const std::string& key, double fallback) {
+    auto it = options.find(key);
+    if (it == options.end()) {
+        return fallback;
+    }
+    std::size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(it->second, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != it->second.size()) {
+        throw std::invalid_argument("bad " + key + " '" + it->second + "'");
+    }
+    return value;
+}
+
+// Parses a non-negative integer option
+unsigned long countOption(const std::map<std::string, std::string>& options, const std::string& key, unsigned long fallback) {
+    auto it = options.find(key);
+    if (it == options.end()) {
+        return fallback;
+    }
+    std::size_t used = 0;
+    unsigned long value = 0;
+    try {
+        value = it->second.find('-') == std::string::npos ? std::stoul(it->second, &used) : 0;
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != it->second.size()) {
+        throw std::invalid_argument("bad " + key + " '" + it->second + "'");
+    }
+    return value;
+}
+
+double quboEnergy(const std::vector<int>& x, const boost::numeric::ublas::matrix<double>& Q) {
+    double energy = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        if (!x[i]) continue;
+        for (std::size_t j = 0; j < x.size(); ++j) {
+            if (x[j]) energy += Q(i, j);
+        }
+    }
+    return energy;
+}
+
+// Outcome of one request before batch scoring
+struct Answer {
+    std::vector<int> selection;   // Selected assets (selection solvers)
+    std::vector<double> weights;  // Portfolio weights
+    double energy = 0.0;          // QUBO energy of the selection
+    bool hasEnergy = false;
+    std::string error;
+};
+
+} // namespace
+
+OptimizationService::OptimizationService(int numThreads)
+    : num_threads(numThreads), served(0), batches(0), pool(numThreads) {}
+
+int OptimizationService::run(std::istream& in, std::ostream& out) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!handleLine(line, out)) {
+            break;
+        }
+        // Batch everything that has already arrived; answer once the client waits for us. in_avail only sees
+        // input waiting in the stream buffer or the file descriptor behind it, so std::cin must be unsynchronized.
+        if (!pending.empty() && in.rdbuf()->in_avail() <= 0) {
+            flush(out);
+        }
+        out.flush();
+    }
+    flush(out);
+    out.flush();
+    return 0;
+}
+
+bool OptimizationService::handleLine(const std::string& line, std::ostream& out) {
+    std::vector<std::string> positional;
+    std::map<std::string, std::string> options;
+    tokenize(line, positional, options);
+    if (positional.empty()) {
+        return true;
+    }
+    const std::string& command = positional[0];
+
+    try {
+        if (command == "quit") {
+            return false;
+        } else if (command == "flush") {
+            flush(out);
+        } else if (command == "stats") {
+            std::size_t qubos = 0;
+            std::size_t factorizations = 0;
+            for (const auto& entry : universes) {
+                qubos += entry.second->qubos.size();
+                factorizations += entry.second->cache->factorizations();
+            }
+            out << "ok stats universes=" << universes.size() << " served=" << served << " pending=" << pending.size()
+                << " qubos=" << qubos << " factorizations=" << factorizations << '\n';
+        } else if (command == "load") {
+            if (positional.size() < 2) {
+                throw std::invalid_argument("usage: load <universe> returns=<csv> [covariance=<csv>]");
+            }
+            load(positional[1], options, out);
+        } else if (command == "optimize") {
+            if (positional.size() < 2) {
+                throw std::invalid_argument("usage: optimize <id> universe=<name> [solver=...]");
+            }
+            Request request;
+            request.id = positional[1];
+            try {
+                request.universe = option(options, "universe", "");
+                request.solver = option(options, "solver", "tabu");
+                request.riskAversion = numberOption(options, "riskAversion", 1.0);
+                request.budget = static_cast<std::size_t>(countOption(options, "budget", 0));
+                request.penalty = numberOption(options, "penalty", 0.0);
+                request.seed = static_cast<unsigned int>(countOption(options, "seed", 42));
+                if (universes.find(request.universe) == universes.end()) {
+                    throw std::invalid_argument("unknown universe '" + request.universe + "'");
+                }
+            } catch (const std::exception& ex) {
+                request.error = ex.what(); // Answered in its place in the batch
+            }
+            pending.push_back(request);
+        } else {
+            throw std::invalid_argument("unknown command");
+        }
+    } catch (const std::exception& ex) {
+        flush(out); // Keep replies in request order
+        out << "error " << command << ' ' << ex.what() << '\n';
+    }
+    return true;
+}
+
+void OptimizationService::load(const std::string& name, const std::map<std::string, std::string>& options, std::ostream& out) {
+    QPO_SCOPED_TIMER("OptimizationService::load");
+    const std::string returnsPath = option(options, "returns", "");
+    if (returnsPath.empty()) {
+        throw std::invalid_argument("load needs returns=<csv>");
+    }
+    // Requests already queued against the old data are answered first
+    if (!pending.empty()) {
+        flush(out);
+    }
+
+    auto universe = std::make_unique<Universe>();
+    auto returns = DataLoader::loadReturns(returnsPath);
+    universe->expectedReturns = DataLoader::meanReturns(returns);
+    const std::string covariancePath = option(options, "covariance", "");
+    universe->covariance = covariancePath.empty() ? DataLoader::sampleCovariance(returns)
+                                                  : DataLoader::loadCovariance(covariancePath);
+    if (universe->covariance.size1() != universe->expectedReturns.size()) {
+        throw std::invalid_argument("covariance and returns cover different assets");
+    }
+    universe->cache = std::make_unique<FactorizationCache>(num_threads);
+    universe->cache->setCovariance(universe->covariance);
+    universe->cache->cholesky();  // Factorize now rather than on the first request
+    universe->evaluator = std::make_unique<BatchEvaluator>(universe->expectedReturns, universe->covariance, 0.0, num_threads);
+    universe->riskParity = std::make_unique<RiskParity>(*universe->cache);
+
+    out << "ok load " << name << " assets=" << universe->expectedReturns.size() << " periods=" << returns.size1() << '\n';
+    universes[name] = std::move(universe);
+}
+
+OptimizationService::QUBOPtr OptimizationService::selectionQUBO(Universe& universe, const Request& request) {
+    const std::size_t n = universe.expectedReturns.size();
+    const std::size_t budget = request.budget > 0 ? std::min(request.budget, n) : std::max<std::size_t>(1, n / 2);
+    double penalty = request.penalty;
+    if (penalty <= 0.0) {
+        // Large enough that adding or dropping an asset beyond the budget never pays on its own
+        for (std::size_t i = 0; i < n; ++i) {
+            penalty = std::max(penalty, request.riskAversion * universe.covariance(i, i) + std::fabs(universe.expectedReturns[i]));
+        }
+    }
+    const QUBOKey key(std::make_pair(request.riskAversion, budget), penalty);
+    auto it = std::find_if(universe.qubos.begin(), universe.qubos.end(), [&key](const auto& entry) { return entry.first == key; });
+    if (it != universe.qubos.end()) {
+        universe.qubos.splice(universe.qubos.begin(), universe.qubos, it);
+        return it->second;
+    }
+
+    QPO_SCOPED_TIMER("OptimizationService::selectionQUBO");
+    boost::numeric::ublas::matrix<double> Q(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            Q(i, j) = request.riskAversion * universe.covariance(i, j) + penalty;
+        }
+        Q(i, i) += -universe.expectedReturns[i] - 2.0 * penalty * static_cast<double>(budget);
+    }
+    universe.qubos.emplace_front(key, std::make_shared<const boost::numeric::ublas::matrix<double>>(std::move(Q)));
+    if (universe.qubos.size() > QUBO_CACHE_SIZE) {
+        universe.qubos.pop_back();
+    }
+    return universe.qubos.front().second;
+}
+
+void OptimizationService::flush(std::ostream& out) {
+    if (pending.empty()) {
+        return;
+    }
+    QPO_SCOPED_TIMER("OptimizationService::flush");
+    std::vector<Request> batch;
+    batch.swap(pending);
+    std::vector<Answer> answers(batch.size());
+
+    // Shared state is prepared serially; the solves below only read it
+    std::vector<QUBOPtr> qubos(batch.size());
+    for (std::size_t r = 0; r < batch.size(); ++r) {
+        if (!batch[r].error.empty()) {
+            answers[r].error = batch[r].error;
+            continue;
+        }
+        Universe& universe = *universes.at(batch[r].universe);
+        try {
+            if (batch[r].solver == "riskparity") {
+                answers[r].weights = universe.riskParity->solve({}).weights;
+            } else {
+                qubos[r] = selectionQUBO(universe, batch[r]);
+            }
+        } catch (const std::exception& ex) {
+            answers[r].error = ex.what();
+        }
+    }
+
+    for (std::size_t r = 0; r < batch.size(); ++r) {
+        if (qubos[r] == nullptr) continue;
+        pool.submit([&, r]() {
+            const Request& request = batch[r];
+            const boost::numeric::ublas::matrix<double>& Q = *qubos[r];
+            const Universe& universe = *universes.at(request.universe);
+            Answer& answer = answers[r];
+            try {
+                if (request.solver == "tabu") {
+                    TabuSearch::Settings settings;
+                    settings.seed = request.seed;
+                    settings.numThreads = 1;
+                    answer.selection = TabuSearch::solve(Q, settings).solution;
+                } else if (request.solver == "ga") {
+                    GeneticAlgorithm::Settings settings;
+                    settings.seed = request.seed;
+                    settings.numThreads = 1;
+                    answer.selection = GeneticAlgorithm(Q.size1(), GeneticAlgorithm::quboFitness(Q, 1), settings).run().solution;
+                } else if (request.solver == "sa") {
+                    auto energy = [&Q](const std::vector<int>& x) { return quboEnergy(x, Q); };
+                    answer.selection = Optimization::simulatedAnnealing(energy, std::vector<int>(Q.size1(), 0), 10.0, 0.999,
+                                                                        20000, request.seed);
+                } else if (request.solver == "annealing") {
+                    QuantumAnnealing annealer(static_cast<int>(Q.size1()));
+                    annealer.setSeed(request.seed);
+                    answer.selection = annealer.solveQUBO(Q);
+                } else if (request.solver == "qpca") {
+                    QPCA::Settings settings;
+                    settings.seed = request.seed;
+                    settings.numThreads = 1;
+                    settings.clusters = std::min<std::size_t>(settings.clusters, std::max<std::size_t>(1, Q.size1() / 4));
+                    auto reducedSolver = [&request](const QPCA::QUBOMatrix& reduced) {
+                        TabuSearch::Settings tabu;
+                        tabu.seed = request.seed;
+                        tabu.numThreads = 1;
+                        return TabuSearch::solve(reduced, tabu).solution;
+                    };
+                    answer.selection = QPCA::solve(Q, universe.covariance, reducedSolver, settings).solution;
+                } else {
+                    throw std::invalid_argument("unknown solver '" + request.solver + "'");
+                }
+                answer.energy = quboEnergy(answer.selection, Q);
+                answer.hasEnergy = true;
+                answer.weights.assign(answer.selection.size(), 0.0);
+                const double selected = static_cast<double>(std::count(answer.selection.begin(), answer.selection.end(), 1));
+                for (std::size_t i = 0; i < answer.selection.size(); ++i) {
+                    if (answer.selection[i] && selected > 0.0) answer.weights[i] = 1.0 / selected;
+                }
+            } catch (const std::exception& ex) {
+                answer.error = ex.what();
+            }
+        });
+    }
+    pool.wait();
+
+    // One batch evaluation per universe over every portfolio of the batch
+    std::map<std::string, std::vector<std::size_t>> byUniverse;
+    for (std::size_t r = 0; r < batch.size(); ++r) {
+        if (answers[r].error.empty()) byUniverse[batch[r].universe].push_back(r);
+    }
+    std::vector<BatchEvaluator::Evaluation> evaluations(batch.size());
+    for (const auto& group : byUniverse) {
+        const Universe& universe = *universes.at(group.first);
+        const std::size_t n = universe.expectedReturns.size();
+        boost::numeric::ublas::matrix<double> weights(group.second.size(), n);
+        for (std::size_t row = 0; row < group.second.size(); ++row) {
+            const std::vector<double>& w = answers[group.second[row]].weights;
+            std::copy(w.begin(), w.end(), &weights.data()[0] + row * n);
+        }
+        auto scored = universe.evaluator->evaluate(weights);
+        for (std::size_t row = 0; row < group.second.size(); ++row) evaluations[group.second[row]] = scored[row];
+    }
+    QPO_COUNTER("OptimizationService::flush.batchSize", batch.size());
+    ++batches;
+
+    out << std::setprecision(10);
+    for (std::size_t r = 0; r < batch.size(); ++r) {
+        const Answer& answer = answers[r];
+        if (!answer.error.empty()) {
+            out << "error " << batch[r].id << ' ' << answer.error << '\n';
+            continue;
+        }
+        const BatchEvaluator::Evaluation& evaluation = evaluations[r];
+        out << "result " << batch[r].id << " solver=" << batch[r].solver;
+        if (answer.hasEnergy) out << " energy=" << answer.energy;
+        out << " return=" << evaluation.expectedReturn << " volatility=" << evaluation.volatility
+            << " sharpe=" << evaluation.sharpeRatio << " weights=";
+        for (std::size_t i = 0; i < answer.weights.size(); ++i) {
+            out << (i ? "," : "") << answer.weights[i];
+        }
+        out << '\n';
+        ++served;
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#ifndef OPTIMIZATION_SERVICE_HPP
+#define OPTIMIZATION_SERVICE_HPP
+
+#include <cstddef>
+#include <istream>
+#include <list>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for covariance and QUBO
+#include "BatchEvaluator.hpp"
+#include "FactorizationCache.hpp"
+#include "WorkStealingPool.hpp"
+#include "../classical_algorithms/RiskParity.hpp"
+
+/**
+ * @class OptimizationService
+ * @brief Long-running optimizer speaking a line protocol on a pair of streams (normally stdin/stdout).
+ *
+ * Market data is loaded once per universe and kept resident together with everything derived from it:
+ * expected returns, covariance and its Cholesky factor (FactorizationCache), the batch evaluator, the
+ * risk-parity warm start and the most recently used asset-selection QUBOs, one per (risk aversion, budget,
+ * penalty). Rebalance requests are queued and solved together when no more input is pending (or on "flush"):
+ * requests run in parallel on the service's work-stealing pool and every universe's portfolios are scored in a
+ * single BatchEvaluator call. Responses are written in request order; a request that cannot be parsed
+ * or names an unknown universe gets its error reply in its place, and errors of other commands are
+ * written after the pending requests have been answered.
+ *
+ * Protocol, one command per line, options as key=value:
+ *   load <universe> returns=<csv> [covariance=<csv>]
+ *   optimize <id> universe=<name> [solver=tabu|ga|sa|annealing|qpca|riskparity] [riskAversion=1]
+ *            [budget=<assets>] [penalty=<weight>] [seed=42]
+ *   flush | stats | quit
+ * Replies: "ok ...", "result <id> ...", "error <id|command> <message>".
+ */
+class OptimizationService {
+public:
+    /**
+     * @brief Constructor for the OptimizationService class.
+     *
+     * @param numThreads Worker threads for solving batched requests, 0 to use every hardware thread.
+     */
+    explicit OptimizationService(int numThreads = 0);
+
+    /**
+     * @brief Serves commands from in until "quit" or end of input, flushing pending requests at the end.
+     *
+     * Requests are batched while more input is already buffered or readable. Synchronized std::cin never
+     * reports pending input, so call std::ios::sync_with_stdio(false) before serving standard input.
+     *
+     * @return Process exit code (0).
+     */
+    int run(std::istream& in, std::ostream& out);
+
+    /**
+     * @brief Handles one protocol line.
+     *
+     * @return false once "quit" was received.
+     */
+    bool handleLine(const std::string& line, std::ostream& out);
+
+    /**
+     * @brief Solves and answers every queued optimize request.
+     */
+    void flush(std::ostream& out);
+
+    /**
+     * @brief Number of optimize requests waiting for the next flush.
+     */
+    std::size_t pendingRequests() const { return pending.size(); }
+
+    /**
+     * @brief Number of non-empty batches flushed so far.
+     */
+    std::size_t flushedBatches() const { return batches; }
+
+private:
+    /**
+     * @brief A queued rebalance request.
+     */
+    struct Request {
+        std::string id;            ///< Client-chosen request identifier.
+        std::string universe;      ///< Universe the request runs against.
+        std::string solver;        ///< Solver name.
+        double riskAversion = 1.0; ///< Weight of the variance against the return.
+        std::size_t budget = 0;    ///< Target number of assets, 0 for half the universe.
+        double penalty = 0.0;      ///< Budget penalty weight, 0 for an automatic choice.
+        unsigned int seed = 42;    ///< Seed of the stochastic solvers.
+        std::string error;         ///< Parse or lookup failure, answered instead of solving.
+    };
+
+    /// Selection QUBO parameters: ((risk aversion, budget), penalty).
+    using QUBOKey = std::pair<std::pair<double, std::size_t>, double>;
+    using QUBOPtr = std::shared_ptr<const boost::numeric::ublas::matrix<double>>;
+
+    /**
+     * @brief Resident state of one loaded universe.
+     */
+    struct Universe {
+        std::vector<double> expectedReturns;                 ///< Mean return per asset.
+        boost::numeric::ublas::matrix<double> covariance;    ///< Covariance of the returns.
+        std::unique_ptr<FactorizationCache> cache;           ///< Covariance and its Cholesky factor.
+        std::unique_ptr<BatchEvaluator> evaluator;           ///< Batch scorer for the universe.
+        std::unique_ptr<RiskParity> riskParity;              ///< Risk-parity solver with warm start.
+        std::list<std::pair<QUBOKey, QUBOPtr>> qubos;       ///< Selection QUBOs, most recently used first.
+    };
+
+    int num_threads;                                          ///< Worker threads.
+    std::map<std::string, std::unique_ptr<Universe>> universes; ///< Loaded universes by name.
+    std::vector<Request> pending;                             ///< Requests waiting for the next flush.
+    std::size_t served;                                       ///< Requests answered so far.
+    std::size_t batches;                                      ///< Batches flushed so far.
+    WorkStealingPool pool;                                    ///< Solves the requests of every batch.
+
+    /**
+     * @brief Loads (or reloads) a universe from CSV files.
+     */
+    void load(const std::string& name, const std::map<std::string, std::string>& options, std::ostream& out);
+
+    /**
+     * @brief Returns the cached selection QUBO lambda Sigma - diag(mu) + penalty (sum x - budget)^2, building it on first use.
+     *
+     * Only the most recently used QUBOs of a universe stay cached; callers keep the returned pointer for the batch.
+     */
+    QUBOPtr selectionQUBO(Universe& universe, const Request& request);
+};
+
+#endif // OPTIMIZATION_SERVICE_HPP
@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Parallel
+ * @brief Minimal fork-join helpers shared by the numerical kernels.
+ */
+class Parallel {
+public:
+    /**
+     * @brief Resolves a requested thread count, mapping 0 (or less) to the number of hardware threads.
+     */
+    static int threadCount(int requested) {
+        if (requested > 0) {
+            return requested;
+        }
+        unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware == 0 ? 1 : static_cast<int>(hardware);
+    }
+
+    /**
+     * @brief Splits [begin, end) into one contiguous chunk per thread and runs fn(lo, hi, thread) on each.
+     *
+     * The calling thread processes the first chunk; the call returns once every chunk is done. Threads are
+     * joined even when a chunk throws, and the exception of the lowest-numbered failing chunk is rethrown
+     * afterwards.
+     *
+     * @param begin First index of the range.
+     * @param end One past the last index of the range.
+     * @param numThreads Number of threads, 0 to use every hardware thread.
+     * @param fn Callable invoked as fn(std::size_t lo, std::size_t hi, int thread).
+     * @throws Whatever fn throws, once every started thread has been joined.
+     */
+    template <typename Function>
+    static void forRange(std::size_t begin, std::size_t end, int numThreads, Function&& fn) {
+        if (end <= begin) {
+            return;
+        }
+        std::size_t count = end - begin;
+        std::size_t threads = std::min<std::size_t>(static_cast<std::size_t>(threadCount(numThreads)), count);
+        std::size_t chunk = (count + threads - 1) / threads;
+
+        std::vector<std::exception_ptr> errors(threads);
+        {
+            JoinGuard pool;
+            for (std::size_t t = 1; t < threads; ++t) {
+                std::size_t lo = begin + t * chunk;
+                std::size_t hi = std::min(end, lo + chunk);
+                if (lo >= hi) break;
+                pool.threads.emplace_back([&fn, &errors, lo, hi, t]() {
+                    try {
+                        fn(lo, hi, static_cast<int>(t));
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+            try {
+                fn(begin, std::min(end, begin + chunk), 0);
+            } catch (...) {
+                errors[0] = std::current_exception();
+            }
+        }
+        for (const std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+private:
+    // Joins every thread on scope exit, so that no joinable std::thread is ever destroyed
+    struct JoinGuard {
+        std::vector<std::thread> threads;
+
+        ~JoinGuard() {
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+    };
+};
+
+#endif // PARALLEL_HPP
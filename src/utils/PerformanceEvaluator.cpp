@@ -0,0 +1,367 @@
+#include "PerformanceEvaluator.hpp"
+#include "Instrumentation.hpp"
+#include "Parallel.hpp"
+#include "../classical_algorithms/Optimization.hpp"
+#include "../quantum_algorithms/QuantumAnnealing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Index of the lowest set bit of a non-zero value
+int lowestSetBit(std::uint64_t value) {
+    int index = 0;
+    while ((value & 1u) == 0) {
+        value >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+} // namespace
+
+PerformanceEvaluator::PerformanceEvaluator(const QUBOMatrix& QUBO_matrix, int runs, unsigned int baseSeed,
+                                           int numThreads, bool pinThreads)
+    : QUBO_matrix(QUBO_matrix), runs(runs), baseSeed(baseSeed), numThreads(Parallel::threadCount(numThreads)),
+      pinThreads(pinThreads), confidence(0.99), tolerance(1e-9), hasReferenceEnergy(false), referenceEnergy(0.0) {
+    if (QUBO_matrix.size1() != QUBO_matrix.size2()) {
+        throw std::invalid_argument("QUBO matrix must be square.");
+    }
+    if (runs <= 0) {
+        throw std::invalid_argument("Number of runs must be positive.");
+    }
+}
+
+void PerformanceEvaluator::addSolver(const std::string& name, QUBOSolver solver, int threadsPerRun) {
+    if (threadsPerRun <= 0) {
+        throw std::invalid_argument("Threads per run must be positive.");
+    }
+    solverNames.push_back(name);
+    solvers.push_back(std::move(solver));
+    solverThreads.push_back(threadsPerRun);
+}
+
+void PerformanceEvaluator::setReferenceEnergy(double energy) {
+    hasReferenceEnergy = true;
+    referenceEnergy = energy;
+}
+
+void PerformanceEvaluator::setConfidence(double confidence) {
+    if (confidence <= 0.0 || confidence >= 1.0) {
+        throw std::invalid_argument("Confidence must lie strictly between 0 and 1.");
+    }
+    this->confidence = confidence;
+}
+
+void PerformanceEvaluator::setTolerance(double tolerance) {
+    this->tolerance = tolerance;
+}
+
+std::vector<PerformanceEvaluator::SolverResult> PerformanceEvaluator::run() {
+    double optimum = referenceEnergy;
+    if (!hasReferenceEnergy) {
+        if (static_cast<int>(QUBO_matrix.size1()) > MAX_BRUTE_FORCE_VARIABLES) {
+            throw std::invalid_argument("Reference energy is required for QUBOs with more than 30 variables.");
+        }
+        optimum = bruteForceMinimum(QUBO_matrix, nullptr, numThreads);
+    }
+
+    std::vector<SolverResult> results;
+    std::vector<double> energies(runs);
+    std::vector<double> seconds(runs);
+    const std::vector<int> cpus = pinThreads ? allowedCpus() : std::vector<int>();
+
+    for (size_t s = 0; s < solvers.size(); ++s) {
+        const QUBOSolver& solver = solvers[s];
+        const std::size_t perRun = static_cast<std::size_t>(solverThreads[s]);
+        std::atomic<int> nextRun(0);
+
+        // Pinned workers get disjoint CPU sets of perRun CPUs each; without enough CPUs nothing is pinned
+        const bool pin = pinThreads && cpus.size() >= perRun;
+        int workers = std::min(numThreads, runs);
+        if (pin) {
+            workers = std::min(workers, static_cast<int>(cpus.size() / perRun));
+        }
+
+        auto worker = [&](int workerIndex) {
+            if (pin) {
+                const auto first = cpus.begin() + static_cast<std::ptrdiff_t>(workerIndex * perRun);
+                pinCurrentThread(std::vector<int>(first, first + static_cast<std::ptrdiff_t>(perRun)));
+            }
+            for (int r = nextRun.fetch_add(1); r < runs; r = nextRun.fetch_add(1)) {
+                QPO_SCOPED_TIMER("PerformanceEvaluator::run.solver");
+                auto start = std::chrono::steady_clock::now();
+                std::vector<int> solution = solver(QUBO_matrix, baseSeed + static_cast<unsigned int>(r));
+                auto stop = std::chrono::steady_clock::now();
+                seconds[r] = std::chrono::duration<double>(stop - start).count();
+                energies[r] = computeEnergy(solution, QUBO_matrix);
+            }
+        };
+
+        // Every worker gets its own thread so that pinning never changes the caller's affinity mask
+        std::vector<std::thread> threads;
+        for (int t = 0; t < workers; ++t) {
+            threads.emplace_back(worker, t);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        SolverResult result;
+        result.solver = solverNames[s];
+        result.runs = runs;
+        result.referenceEnergy = optimum;
+        result.bestEnergy = std::numeric_limits<double>::infinity();
+        result.worstEnergy = -std::numeric_limits<double>::infinity();
+        double scale = std::max(std::abs(optimum), 1.0);
+        for (int r = 0; r < runs; ++r) {
+            result.bestEnergy = std::min(result.bestEnergy, energies[r]);
+            result.worstEnergy = std::max(result.worstEnergy, energies[r]);
+            result.meanEnergy += energies[r];
+            result.meanGap += (energies[r] - optimum) / scale;
+            result.meanSeconds += seconds[r];
+            if (energies[r] <= optimum + tolerance) {
+                ++result.hits;
+            }
+        }
+        result.meanEnergy /= runs;
+        result.meanGap /= runs;
+        result.meanSeconds /= runs;
+        result.successProbability = static_cast<double>(result.hits) / runs;
+        result.timeToSolution = timeToSolution(result.meanSeconds, result.successProbability, confidence);
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+double PerformanceEvaluator::computeEnergy(const std::vector<int>& state, const QUBOMatrix& QUBO_matrix) {
+    double energy = 0.0;
+    for (size_t i = 0; i < state.size(); ++i) {
+        if (state[i] == 0) continue;
+        for (size_t j = 0; j < state.size(); ++j) {
+            energy += QUBO_matrix(i, j) * state[i] * state[j];
+        }
+    }
+    return energy;
+}
+
+double PerformanceEvaluator::bruteForceMinimum(const QUBOMatrix& QUBO_matrix, std::vector<int>* argmin, int numThreads) {
+    QPO_SCOPED_TIMER("PerformanceEvaluator::bruteForceMinimum");
+    const int n = static_cast<int>(QUBO_matrix.size1());
+    if (n > MAX_BRUTE_FORCE_VARIABLES) {
+        throw std::invalid_argument("Brute-force enumeration is limited to 30 variables.");
+    }
+    if (n == 0) {
+        if (argmin) argmin->clear();
+        return 0.0;
+    }
+
+    // Diagonal and symmetrised off-diagonal couplings, so flipping bit k changes the energy by
+    // +/-(diag[k] + field[k]) with field[k] = sum_j coupling[k][j] * x_j.
+    std::vector<double> diag(n);
+    std::vector<double> coupling(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        diag[i] = QUBO_matrix(i, i);
+        for (int j = 0; j < n; ++j) {
+            if (i != j) coupling[static_cast<size_t>(i) * n + j] = QUBO_matrix(i, j) + QUBO_matrix(j, i);
+        }
+    }
+
+    int threads = Parallel::threadCount(numThreads);
+    int prefixBits = 0;
+    while (prefixBits < n && (1 << prefixBits) < threads * 8) {
+        ++prefixBits;
+    }
+    const int lowBits = n - prefixBits;
+    const std::uint64_t chunks = std::uint64_t(1) << prefixBits;
+    const std::uint64_t steps = std::uint64_t(1) << lowBits;
+
+    std::atomic<std::uint64_t> nextChunk(0);
+    std::vector<double> bestEnergies(threads, std::numeric_limits<double>::infinity());
+    std::vector<std::uint64_t> bestStates(threads, 0);
+
+    auto worker = [&](int t) {
+        std::vector<double> field(n);
+        for (std::uint64_t chunk = nextChunk.fetch_add(1); chunk < chunks; chunk = nextChunk.fetch_add(1)) {
+            std::uint64_t state = chunk << lowBits;
+
+            double energy = 0.0;
+            for (int k = 0; k < n; ++k) {
+                field[k] = 0.0;
+                for (int j = lowBits; j < n; ++j) {
+                    if ((state >> j) & 1u) field[k] += coupling[static_cast<size_t>(k) * n + j];
+                }
+            }
+            for (int k = lowBits; k < n; ++k) {
+                if ((state >> k) & 1u) energy += diag[k] + 0.5 * field[k];
+            }
+            if (energy < bestEnergies[t]) {
+                bestEnergies[t] = energy;
+                bestStates[t] = state;
+            }
+
+            for (std::uint64_t g = 1; g < steps; ++g) {
+                int k = lowestSetBit(g);
+                double sign = ((state >> k) & 1u) ? -1.0 : 1.0;
+                energy += sign * (diag[k] + field[k]);
+                state ^= std::uint64_t(1) << k;
+                const double* column = &coupling[static_cast<size_t>(k) * n];
+                for (int j = 0; j < n; ++j) {
+                    field[j] += sign * column[j];
+                }
+                if (energy < bestEnergies[t]) {
+                    bestEnergies[t] = energy;
+                    bestStates[t] = state;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    int best = static_cast<int>(std::min_element(bestEnergies.begin(), bestEnergies.end()) - bestEnergies.begin());
+    if (argmin) {
+        argmin->assign(n, 0);
+        for (int k = 0; k < n; ++k) {
+            (*argmin)[k] = static_cast<int>((bestStates[best] >> k) & 1u);
+        }
+    }
+    return bestEnergies[best];
+}
+
+double PerformanceEvaluator::timeToSolution(double runSeconds, double successProbability, double confidence) {
+    if (successProbability <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (successProbability >= confidence) {
+        return runSeconds; // A single run already reaches the target confidence
+    }
+    return runSeconds * std::log(1.0 - confidence) / std::log(1.0 - successProbability);
+}
+
+void PerformanceEvaluator::writeCSV(const std::vector<SolverResult>& results, std::ostream& out) {
+    out << "solver,runs,hits,reference_energy,best_energy,mean_energy,worst_energy,mean_gap,"
+           "mean_seconds,success_probability,time_to_solution\n";
+    out << std::setprecision(10);
+    for (const SolverResult& r : results) {
+        out << r.solver << ',' << r.runs << ',' << r.hits << ',' << r.referenceEnergy << ','
+            << r.bestEnergy << ',' << r.meanEnergy << ',' << r.worstEnergy << ',' << r.meanGap << ','
+            << r.meanSeconds << ',' << r.successProbability << ',';
+        if (std::isinf(r.timeToSolution)) {
+            out << "inf";
+        } else {
+            out << r.timeToSolution;
+        }
+        out << '\n';
+    }
+}
+
+void PerformanceEvaluator::writeJSON(const std::vector<SolverResult>& results, std::ostream& out) {
+    out << std::setprecision(10) << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SolverResult& r = results[i];
+        out << "  {\"solver\": \"" << r.solver << "\", \"runs\": " << r.runs << ", \"hits\": " << r.hits
+            << ", \"reference_energy\": " << r.referenceEnergy << ", \"best_energy\": " << r.bestEnergy
+            << ", \"mean_energy\": " << r.meanEnergy << ", \"worst_energy\": " << r.worstEnergy
+            << ", \"mean_gap\": " << r.meanGap << ", \"mean_seconds\": " << r.meanSeconds
+            << ", \"success_probability\": " << r.successProbability << ", \"time_to_solution\": ";
+        if (std::isinf(r.timeToSolution)) {
+            out << "null"; // JSON has no infinity; null marks a solver that never reached the optimum
+        } else {
+            out << r.timeToSolution;
+        }
+        out << (i + 1 < results.size() ? "},\n" : "}\n");
+    }
+    out << "]\n";
+}
+
+PerformanceEvaluator::QUBOSolver PerformanceEvaluator::simulatedAnnealingSolver(double initialTemperature, double coolingRate, int maxIterations) {
+    return [=](const QUBOMatrix& QUBO_matrix, unsigned int seed) {
+        auto energyFunction = [&QUBO_matrix](const std::vector<int>& state) {
+            return computeEnergy(state, QUBO_matrix);
+        };
+        std::vector<int> initialState(QUBO_matrix.size1(), 0);
+        return Optimization::simulatedAnnealing(energyFunction, initialState, initialTemperature, coolingRate, maxIterations, seed);
+    };
+}
+
+PerformanceEvaluator::QUBOSolver PerformanceEvaluator::quantumAnnealingSolver() {
+    return [](const QUBOMatrix& QUBO_matrix, unsigned int seed) {
+        QuantumAnnealing annealer(static_cast<int>(QUBO_matrix.size1()));
+        annealer.setSeed(seed);
+        return annealer.solveQUBO(QUBO_matrix);
+    };
+}
+
+PerformanceEvaluator::QUBOSolver PerformanceEvaluator::tabuSearchSolver(const TabuSearch::Settings& settings) {
+    return [settings](const QUBOMatrix& QUBO_matrix, unsigned int seed) {
+        TabuSearch::Settings runSettings = settings;
+        runSettings.seed = seed;
+        return TabuSearch::solve(QUBO_matrix, runSettings).solution;
+    };
+}
+
+std::vector<int> PerformanceEvaluator::allowedCpus() {
+    std::vector<int> cpus;
+#if defined(_WIN32)
+    DWORD_PTR process = 0;
+    DWORD_PTR system = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process, &system)) {
+        for (int cpu = 0; cpu < static_cast<int>(8 * sizeof(DWORD_PTR)); ++cpu) {
+            if (process & (DWORD_PTR(1) << cpu)) cpus.push_back(cpu);
+        }
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        for (int cpu = 0; cpu < Parallel::threadCount(0); ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+void PerformanceEvaluator::pinCurrentThread(const std::vector<int>& cpus) {
+#if defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) mask |= DWORD_PTR(1) << (cpu % (8 * sizeof(DWORD_PTR)));
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpus;
+#endif
+}
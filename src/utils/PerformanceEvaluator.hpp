@@ -0,0 +1,181 @@
+#pragma once
+
+#ifndef PERFORMANCE_EVALUATOR_HPP
+#define PERFORMANCE_EVALUATOR_HPP
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for QUBO
+#include "../classical_algorithms/TabuSearch.hpp"
+
+/**
+ * @class PerformanceEvaluator
+ * @brief Time-to-target and solution-quality harness comparing QUBO solvers.
+ *
+ * Every registered solver is run many times on the same QUBO instance, with run r of every solver
+ * receiving the same seed (baseSeed + r). Each run is timed and its energy compared against a reference
+ * optimum, which is computed by exhaustive enumeration for problems with up to 30 variables or supplied
+ * by the caller for larger instances. From the success probability p and the mean run time t the harness
+ * reports the time-to-solution at the requested confidence, TTS = t * ln(1 - confidence) / ln(1 - p).
+ *
+ * Runs are spread across worker threads. When pinning is enabled, each worker is pinned to its own
+ * disjoint set of CPUs. The CPUs come from the process's allowed set, and each set is as large as the
+ * solver's thread count, so a multithreaded solver keeps all the cores it was registered with and
+ * solvers are compared under identical conditions.
+ */
+class PerformanceEvaluator {
+public:
+    using QUBOMatrix = boost::numeric::ublas::matrix<double>;
+
+    /// A solver under test: maps a QUBO matrix and an RNG seed to a binary solution vector.
+    using QUBOSolver = std::function<std::vector<int>(const QUBOMatrix&, unsigned int)>;
+
+    /// Largest problem size for which the reference optimum is found by brute force.
+    static constexpr int MAX_BRUTE_FORCE_VARIABLES = 30;
+
+    /**
+     * @brief Aggregated statistics for one solver over all of its runs.
+     */
+    struct SolverResult {
+        std::string solver;           ///< Name the solver was registered under.
+        int runs = 0;                 ///< Number of runs performed.
+        int hits = 0;                 ///< Runs whose energy reached the reference optimum (within tolerance).
+        double referenceEnergy = 0.0; ///< Reference optimum the runs were scored against.
+        double bestEnergy = 0.0;      ///< Lowest energy seen over all runs.
+        double meanEnergy = 0.0;      ///< Mean energy over all runs.
+        double worstEnergy = 0.0;     ///< Highest energy seen over all runs.
+        double meanGap = 0.0;         ///< Mean relative gap (E - E_ref) / max(|E_ref|, 1).
+        double meanSeconds = 0.0;     ///< Mean wall-clock time of a single run.
+        double successProbability = 0.0; ///< hits / runs.
+        double timeToSolution = 0.0;  ///< Time-to-solution at the configured confidence, +inf if never hit.
+    };
+
+    /**
+     * @brief Constructor for the PerformanceEvaluator class.
+     *
+     * @param QUBO_matrix The QUBO instance every solver is run on.
+     * @param runs Number of runs per solver.
+     * @param baseSeed Seed of the first run; run r uses baseSeed + r for every solver.
+     * @param numThreads Number of worker threads, 0 to use every hardware thread.
+     * @param pinThreads Whether worker threads are pinned to one core each.
+     */
+    PerformanceEvaluator(const QUBOMatrix& QUBO_matrix, int runs, unsigned int baseSeed,
+                         int numThreads = 0, bool pinThreads = true);
+
+    /**
+     * @brief Registers a solver to be included in the comparison.
+     *
+     * @param name Name used in the result tables.
+     * @param solver The solver; it must be safe to call concurrently from several threads.
+     * @param threadsPerRun Threads one run of the solver uses; each pinned worker gets this many CPUs, and
+     *                      fewer workers run concurrently when the allowed CPUs do not suffice.
+     * @throws std::invalid_argument if threadsPerRun is not positive.
+     */
+    void addSolver(const std::string& name, QUBOSolver solver, int threadsPerRun = 1);
+
+    /**
+     * @brief Supplies the known optimum for instances too large for brute-force enumeration.
+     *
+     * @param energy The optimal (or best known) energy of the instance.
+     */
+    void setReferenceEnergy(double energy);
+
+    /**
+     * @brief Sets the confidence level of the time-to-solution metric (0.99 by default).
+     */
+    void setConfidence(double confidence);
+
+    /**
+     * @brief Sets the absolute energy tolerance under which a run counts as having hit the optimum.
+     */
+    void setTolerance(double tolerance);
+
+    /**
+     * @brief Runs every registered solver and returns one result row per solver.
+     *
+     * @return Aggregated results in registration order.
+     * @throws std::invalid_argument if the problem has more than 30 variables and no reference energy was set.
+     */
+    std::vector<SolverResult> run();
+
+    /**
+     * @brief Computes the energy x^T Q x of a binary vector.
+     */
+    static double computeEnergy(const std::vector<int>& state, const QUBOMatrix& QUBO_matrix);
+
+    /**
+     * @brief Finds the exact minimum of a QUBO by Gray-code enumeration of all 2^n states.
+     *
+     * The enumeration is split over the highest bits so that each thread walks its own sub-cube,
+     * updating the energy in O(n) per flipped bit.
+     *
+     * @param QUBO_matrix The QUBO instance, with at most 30 variables.
+     * @param argmin If non-null, receives an optimal state.
+     * @param numThreads Number of worker threads, 0 to use every hardware thread.
+     * @return The minimum energy.
+     * @throws std::invalid_argument if the problem has more than 30 variables.
+     */
+    static double bruteForceMinimum(const QUBOMatrix& QUBO_matrix, std::vector<int>* argmin = nullptr, int numThreads = 0);
+
+    /**
+     * @brief Time-to-solution for a given run time and per-run success probability.
+     *
+     * The result is never shorter than a single run; it is +inf when no run succeeded.
+     */
+    static double timeToSolution(double runSeconds, double successProbability, double confidence = 0.99);
+
+    /**
+     * @brief Writes the result table as CSV with a header row.
+     */
+    static void writeCSV(const std::vector<SolverResult>& results, std::ostream& out);
+
+    /**
+     * @brief Writes the result table as a JSON array of objects.
+     */
+    static void writeJSON(const std::vector<SolverResult>& results, std::ostream& out);
+
+    /**
+     * @brief Adapter running Optimization::simulatedAnnealing from the all-zero state on the QUBO energy.
+     */
+    static QUBOSolver simulatedAnnealingSolver(double initialTemperature, double coolingRate, int maxIterations);
+
+    /**
+     * @brief Adapter running QuantumAnnealing::solveQUBO on the instance.
+     */
+    static QUBOSolver quantumAnnealingSolver();
+
+    /**
+     * @brief Adapter running TabuSearch::solve with the given settings; the run seed replaces settings.seed.
+     *
+     * Register it with threadsPerRun equal to settings.numThreads, so that pinned workers get enough CPUs.
+     */
+    static QUBOSolver tabuSearchSolver(const TabuSearch::Settings& settings);
+
+private:
+    QUBOMatrix QUBO_matrix;                    ///< The problem instance under test.
+    int runs;                                  ///< Runs per solver.
+    unsigned int baseSeed;                     ///< Seed of run 0.
+    int numThreads;                            ///< Worker thread count.
+    bool pinThreads;                           ///< Pin each worker to a core.
+    double confidence;                         ///< Confidence level of the TTS metric.
+    double tolerance;                          ///< Absolute tolerance for a run to count as a hit.
+    bool hasReferenceEnergy;                   ///< Whether the caller supplied the optimum.
+    double referenceEnergy;                    ///< The caller-supplied optimum.
+    std::vector<std::string> solverNames;      ///< Registered solver names.
+    std::vector<QUBOSolver> solvers;           ///< Registered solvers.
+    std::vector<int> solverThreads;            ///< Threads per run of each registered solver.
+
+    /**
+     * @brief Logical CPUs the process may run on, in ascending order.
+     */
+    static std::vector<int> allowedCpus();
+
+    /**
+     * @brief Pins the calling thread to the given logical CPUs (no-op on unsupported platforms).
+     */
+    static void pinCurrentThread(const std::vector<int>& cpus);
+};
+
+#endif // PERFORMANCE_EVALUATOR_HPP
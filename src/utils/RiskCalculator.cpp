@@ -0,0 +1,663 @@
+#include "RiskCalculator.hpp"
+#include "Checkpoint.hpp"
+#include "Instrumentation.hpp"
+#include "LinearAlgebra.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <boost/math/distributions/normal.hpp>
+#include <boost/random/sobol.hpp>
+
+namespace {
+
+constexpr std::size_t SEGMENT_BLOCKS = 64; // Blocks per simulation segment; bounds per-block buffers and the wait for a stop request
+
+std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** stream; one independent stream per scenario block
+class BlockRandom {
+public:
+    BlockRandom(std::uint64_t seed, std::uint64_t block) {
+        std::uint64_t state = seed ^ (block * 0xD1B54A32D192ED03ull);
+        for (std::uint64_t& word : s) word = splitMix64(state);
+    }
+
+    std::uint64_t next() {
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in (0, 1), never exactly 0 so it is safe to take the logarithm
+    double uniform() {
+        return (static_cast<double>(next() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    std::uint64_t s[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+// Fills out[0, count) with standard normals using a batched Box-Muller transform
+void fillNormals(BlockRandom& rng, double* out, std::size_t count, std::vector<double>& scratch) {
+    const double twoPi = 6.283185307179586;
+    std::size_t pairs = (count + 1) / 2;
+    scratch.resize(2 * pairs);
+    for (std::size_t i = 0; i < 2 * pairs; ++i) {
+        scratch[i] = rng.uniform();
+    }
+    const double* u1 = scratch.data();
+    const double* u2 = scratch.data() + pairs;
+    std::size_t full = count / 2;
+    for (std::size_t i = 0; i < full; ++i) {
+        const double radius = std::sqrt(-2.0 * std::log(u1[i]));
+        const double angle = twoPi * u2[i];
+        out[2 * i] = radius * std::cos(angle);
+        out[2 * i + 1] = radius * std::sin(angle);
+    }
+    if (count % 2 != 0) {
+        out[count - 1] = std::sqrt(-2.0 * std::log(u1[full])) * std::cos(twoPi * u2[full]);
+    }
+}
+
+// Keeps only the tailSize largest losses of a buffer (order is not preserved)
+void trimTail(std::vector<double>& losses, std::size_t tailSize) {
+    if (losses.size() > tailSize) {
+        std::nth_element(losses.begin(), losses.begin() + tailSize, losses.end(), std::greater<double>());
+        losses.resize(tailSize);
+    }
+}
+
+// Inverse of the standard normal CDF: Acklam's rational approximation refined by one Halley step
+double inverseNormal(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double low = 0.02425;
+
+    double x;
+    if (p < low) {
+        const double q = std::sqrt(-2.0 * std::log(p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    } else if (p <= 1.0 - low) {
+        const double q = p - 0.5;
+        const double r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    } else {
+        const double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+
+    const double e = 0.5 * std::erfc(-x / std::sqrt(2.0)) - p;
+    const double u = e * std::sqrt(2.0 * 3.141592653589793) * std::exp(0.5 * x * x);
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+// Brownian bridge on the unit-spaced times 1..steps: draw 0 fixes the terminal value, later draws
+// fill in midpoints, so the leading (best-distributed) quasi-random coordinates carry the most variance
+class BrownianBridge {
+public:
+    explicit BrownianBridge(std::size_t steps)
+        : bridgeIndex(steps), leftIndex(steps), rightIndex(steps), leftWeight(steps), rightWeight(steps), stdDev(steps) {
+        std::vector<std::size_t> populated(steps, 0);
+        populated[steps - 1] = 1;
+        bridgeIndex[0] = steps - 1;
+        stdDev[0] = std::sqrt(static_cast<double>(steps));
+        for (std::size_t i = 1, j = 0; i < steps; ++i) {
+            while (populated[j]) ++j;
+            std::size_t k = j;
+            while (!populated[k]) ++k;
+            const std::size_t l = j + ((k - 1 - j) >> 1);
+            populated[l] = i;
+            bridgeIndex[i] = l;
+            leftIndex[i] = j;
+            rightIndex[i] = k;
+            const double tLeft = static_cast<double>(j);  // Time of the left neighbour (0 at the origin)
+            const double tMid = static_cast<double>(l + 1);
+            const double tRight = static_cast<double>(k + 1);
+            leftWeight[i] = (tRight - tMid) / (tRight - tLeft);
+            rightWeight[i] = (tMid - tLeft) / (tRight - tLeft);
+            stdDev[i] = std::sqrt((tMid - tLeft) * (tRight - tMid) / (tRight - tLeft));
+            j = k + 1;
+            if (j >= steps) j = 0;
+        }
+    }
+
+    // Builds the path W(1..steps) from draws[0..steps) read with the given stride
+    void transform(const double* draws, std::size_t stride, double* path) const {
+        const std::size_t steps = bridgeIndex.size();
+        path[steps - 1] = stdDev[0] * draws[0];
+        for (std::size_t i = 1; i < steps; ++i) {
+            const std::size_t j = leftIndex[i];
+            const std::size_t l = bridgeIndex[i];
+            const double left = j == 0 ? 0.0 : leftWeight[i] * path[j - 1];
+            path[l] = left + rightWeight[i] * path[rightIndex[i]] + stdDev[i] * draws[i * stride];
+        }
+    }
+
+private:
+    std::vector<std::size_t> bridgeIndex;
+    std::vector<std::size_t> leftIndex;
+    std::vector<std::size_t> rightIndex;
+    std::vector<double> leftWeight;
+    std::vector<double> rightWeight;
+    std::vector<double> stdDev;
+};
+
+// Produces the standardized terminal normals of one replication, block by block
+class ScenarioSource {
+public:
+    ScenarioSource(const RiskCalculator::SimulationSettings& settings, std::size_t numAssets, std::size_t replication,
+                   std::size_t blocksPerReplication, std::size_t drawsPerReplication)
+        : settings(settings), numAssets(numAssets), steps(settings.horizonSteps),
+          quasiRandom(settings.sampling != RiskCalculator::SamplingMethod::PseudoRandom),
+          dimensions(numAssets * (quasiRandom ? settings.horizonSteps : 1)),
+          sobolDimensions(std::min<std::size_t>(dimensions, boost::random::detail::qrng_tables::sobol::max_dimension)),
+          streamOffset(replication * blocksPerReplication), pointOffset(0), bridge(settings.horizonSteps) {
+        if (!quasiRandom) {
+            return;
+        }
+        sobol.reset(new boost::random::sobol_engine<std::uint32_t, 32>(sobolDimensions));
+        if (settings.sampling == RiskCalculator::SamplingMethod::ScrambledSobol) {
+            // Random digital shift: every replication XORs the same points with its own random words
+            BlockRandom rng(settings.seed ^ 0x5D2A9F1C3B7E4806ull, replication);
+            shifts.resize(sobolDimensions);
+            for (std::uint32_t& shift : shifts) shift = static_cast<std::uint32_t>(rng.next() >> 32);
+        } else {
+            pointOffset = replication * drawsPerReplication; // Plain Sobol: disjoint stretches per replication
+        }
+    }
+
+    // Fills rows x numAssets standard normals for the draws [firstDraw, firstDraw + rows) of the replication
+    void fill(std::size_t block, std::uint64_t firstDraw, std::size_t rows, double* out) {
+        BlockRandom rng(settings.seed, streamOffset + block);
+        if (!quasiRandom) {
+            fillNormals(rng, out, rows * numAssets, scratch);
+            return;
+        }
+
+        coordinates.resize(dimensions);
+        path.resize(steps);
+        sobol->seed();
+        sobol->discard((pointOffset + firstDraw) * sobolDimensions);
+        const double scale = 1.0 / 4294967296.0;
+        const double terminalScale = 1.0 / std::sqrt(static_cast<double>(steps));
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t d = 0; d < sobolDimensions; ++d) {
+                std::uint32_t x = (*sobol)();
+                if (!shifts.empty()) x ^= shifts[d];
+                coordinates[d] = inverseNormal((static_cast<double>(x) + 0.5) * scale);
+            }
+            if (dimensions > sobolDimensions) {
+                // Beyond the Sobol table the least important coordinates are padded with pseudo-random draws
+                fillNormals(rng, coordinates.data() + sobolDimensions, dimensions - sobolDimensions, scratch);
+            }
+
+            double* terminal = out + row * numAssets;
+            for (std::size_t i = 0; i < numAssets; ++i) {
+                if (settings.pathConstruction == RiskCalculator::PathConstruction::BrownianBridge) {
+                    bridge.transform(coordinates.data() + i, numAssets, path.data());
+                    terminal[i] = path[steps - 1] * terminalScale;
+                } else {
+                    double sum = 0.0;
+                    for (std::size_t s = 0; s < steps; ++s) sum += coordinates[s * numAssets + i];
+                    terminal[i] = sum * terminalScale;
+                }
+            }
+        }
+    }
+
+private:
+    const RiskCalculator::SimulationSettings& settings;
+    std::size_t numAssets;
+    std::size_t steps;
+    bool quasiRandom;
+    std::size_t dimensions;
+    std::size_t sobolDimensions;
+    std::uint64_t streamOffset;
+    std::uint64_t pointOffset;
+    BrownianBridge bridge;
+    std::unique_ptr<boost::random::sobol_engine<std::uint32_t, 32>> sobol;
+    std::vector<std::uint32_t> shifts;
+    std::vector<double> coordinates;
+    std::vector<double> path;
+    std::vector<double> scratch;
+};
+
+// Per-portfolio results of one replication
+struct ReplicationEstimate {
+    std::vector<double> valueAtRisk;
+    std::vector<double> conditionalValueAtRisk;
+    std::vector<double> shiftedMean;         // Mean of the P&L minus its analytic mean
+    std::vector<double> shiftedSecondMoment; // Second moment about the analytic mean (the control variate)
+};
+
+// Running state of a replication at a block boundary; everything needed to continue it
+struct ReplicationProgress {
+    std::size_t nextBlock = 0;
+    std::vector<double> sums;               // Sum of the shifted P&L per portfolio over the finished blocks
+    std::vector<double> squares;            // Sum of its squares
+    std::vector<std::vector<double>> tails; // Worst losses per portfolio
+};
+
+// Simulates the remaining blocks of a replication in segments ending at every multiple of SEGMENT_BLOCKS
+// (and of checkpointBlocks when checkpointing), so the per-block buffers stay bounded however many scenarios
+// run; onSegment, if any, is called between segments. Per-block partial sums are folded in block order and the tail is sorted before it is summed, so
+// the estimate depends neither on the thread count nor on the segmenting.
+ReplicationEstimate simulateReplication(const RiskCalculator::SimulationSettings& settings, std::size_t replication,
+                                        std::size_t scenarios, std::size_t numAssets,
+                                        const std::vector<double>& loadings, const std::vector<double>& means,
+                                        ReplicationProgress& progress, const std::function<void()>& onSegment) {
+    const std::size_t count = means.size();
+    const std::size_t tailSize = std::max<std::size_t>(1, static_cast<std::size_t>(
+        std::ceil((1.0 - settings.confidence) * static_cast<double>(scenarios))));
+    const std::size_t numBlocks = (scenarios + settings.blockSize - 1) / settings.blockSize;
+    const std::size_t drawsPerBlock = settings.antithetic ? (settings.blockSize + 1) / 2 : settings.blockSize;
+    if (progress.sums.empty()) {
+        progress.sums.assign(count, 0.0);
+        progress.squares.assign(count, 0.0);
+        progress.tails.assign(count, std::vector<double>());
+    }
+
+    while (progress.nextBlock < numBlocks) {
+        const std::size_t first = progress.nextBlock;
+        std::size_t last = std::min(numBlocks, (first / SEGMENT_BLOCKS + 1) * SEGMENT_BLOCKS);
+        if (onSegment && settings.checkpointBlocks > 0) {
+            last = std::min(last, (first / settings.checkpointBlocks + 1) * settings.checkpointBlocks);
+        }
+        const int threads = static_cast<int>(std::min<std::size_t>(Parallel::threadCount(settings.numThreads), last - first));
+
+        // Per-thread worst losses, per-block moments of the P&L shifted by its mean
+        std::vector<std::vector<std::vector<double>>> tails(threads, std::vector<std::vector<double>>(count));
+        std::vector<double> blockSums((last - first) * count);
+        std::vector<double> blockSquares((last - first) * count);
+
+        Parallel::forRange(first, last, threads, [&](std::size_t firstBlock, std::size_t lastBlock, int t) {
+            ScenarioSource source(settings, numAssets, replication, numBlocks, numBlocks * drawsPerBlock);
+            std::vector<double> normals(drawsPerBlock * numAssets);
+            std::vector<double> pnl(drawsPerBlock * count);
+            for (auto& tail : tails[t]) tail.reserve(tailSize + settings.blockSize);
+
+            for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+                const std::size_t rows = std::min(settings.blockSize, scenarios - block * settings.blockSize);
+                const std::size_t draws = settings.antithetic ? (rows + 1) / 2 : rows;
+                source.fill(block, block * drawsPerBlock, draws, normals.data());
+                LinearAlgebra::gemm(draws, count, numAssets, normals.data(), numAssets, loadings.data(), count,
+                                    pnl.data(), count, false, 1);
+
+                for (std::size_t p = 0; p < count; ++p) {
+                    std::vector<double>& tail = tails[t][p];
+                    double sum = 0.0;
+                    double square = 0.0;
+                    for (std::size_t r = 0; r < rows; ++r) {
+                        // Antithetic scenarios reuse the P&L of their mirrored draw with the opposite sign
+                        const double shifted = r < draws ? pnl[r * count + p] : -pnl[(r - draws) * count + p];
+                        sum += shifted;
+                        square += shifted * shifted;
+                        tail.push_back(-(means[p] + shifted));
+                    }
+                    blockSums[(block - first) * count + p] = sum;
+                    blockSquares[(block - first) * count + p] = square;
+                    trimTail(tail, tailSize);
+                }
+            }
+        });
+
+        for (std::size_t block = 0; block < last - first; ++block) {
+            for (std::size_t p = 0; p < count; ++p) {
+                progress.sums[p] += blockSums[block * count + p];
+                progress.squares[p] += blockSquares[block * count + p];
+            }
+        }
+        for (std::size_t p = 0; p < count; ++p) {
+            std::vector<double>& merged = progress.tails[p];
+            for (int t = 0; t < threads; ++t) {
+                merged.insert(merged.end(), tails[t][p].begin(), tails[t][p].end());
+            }
+            trimTail(merged, tailSize);
+        }
+        progress.nextBlock = last;
+        if (last < numBlocks && onSegment) {
+            onSegment();
+        }
+    }
+
+    ReplicationEstimate estimate;
+    estimate.valueAtRisk.resize(count);
+    estimate.conditionalValueAtRisk.resize(count);
+    estimate.shiftedMean.resize(count);
+    estimate.shiftedSecondMoment.resize(count);
+    const double n = static_cast<double>(scenarios);
+    std::vector<double> tail;
+    for (std::size_t p = 0; p < count; ++p) {
+        tail = progress.tails[p];
+        std::sort(tail.begin(), tail.end(), std::greater<double>());
+
+        estimate.shiftedMean[p] = progress.sums[p] / n;
+        estimate.shiftedSecondMoment[p] = progress.squares[p] / n;
+        estimate.valueAtRisk[p] = tail.back();
+        double tailSum = 0.0;
+        for (double loss : tail) tailSum += loss;
+        estimate.conditionalValueAtRisk[p] = tailSum / static_cast<double>(tail.size());
+    }
+    return estimate;
+}
+
+// Averages per-replication estimates, optionally regressing out a control with known expectation,
+// and returns the standard error of the (corrected) mean
+void combineReplications(const std::vector<double>& values, const std::vector<double>& controls, double controlExpectation,
+                         bool useControl, double& estimate, double& standardError) {
+    const double r = static_cast<double>(values.size());
+    double meanValue = 0.0;
+    double meanControl = 0.0;
+    for (std::size_t k = 0; k < values.size(); ++k) {
+        meanValue += values[k] / r;
+        meanControl += controls[k] / r;
+    }
+
+    double beta = 0.0;
+    if (useControl) {
+        double controlVariance = 0.0;
+        double covariance = 0.0;
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            controlVariance += (controls[k] - meanControl) * (controls[k] - meanControl);
+            covariance += (controls[k] - meanControl) * (values[k] - meanValue);
+        }
+        beta = controlVariance > 0.0 ? covariance / controlVariance : 0.0;
+    }
+
+    estimate = meanValue - beta * (meanControl - controlExpectation);
+    standardError = 0.0;
+    const double degrees = r - (useControl ? 2.0 : 1.0);
+    if (degrees > 0.0) {
+        double residual = 0.0;
+        for (std::size_t k = 0; k < values.size(); ++k) {
+            const double e = values[k] - meanValue - beta * (controls[k] - meanControl);
+            residual += e * e;
+        }
+        standardError = std::sqrt(residual / degrees / r);
+    }
+}
+
+} // namespace
+
+RiskCalculator::RiskCalculator(const std::vector<double>& expectedReturns, const boost::numeric::ublas::matrix<double>& covariance,
+                               int numThreads)
+    : num_assets(expectedReturns.size()), expected_returns(expectedReturns), num_threads(numThreads) {
+    if (covariance.size1() != num_assets || covariance.size2() != num_assets) {
+        throw std::invalid_argument("Covariance dimensions must match the number of expected returns.");
+    }
+    this->covariance.assign(covariance.data().begin(), covariance.data().end());
+    cholesky_factor = this->covariance;
+
+    QPO_SCOPED_TIMER("RiskCalculator::cholesky");
+    if (!LinearAlgebra::cholesky(cholesky_factor.data(), num_assets, num_threads)) {
+        throw std::invalid_argument("Covariance matrix must be positive definite.");
+    }
+}
+
+void RiskCalculator::loadingsAndMeans(const boost::numeric::ublas::matrix<double>& portfolios,
+                                      std::vector<double>& loadings, std::vector<double>& means) const {
+    if (portfolios.size2() != num_assets) {
+        throw std::invalid_argument("Portfolio weights must have one column per asset.");
+    }
+    const std::size_t count = portfolios.size1();
+    const double* weights = &portfolios.data()[0];
+
+    // (W * L)^T = L^T * W^T: factor loadings of each portfolio on the independent normals
+    std::vector<double> transposed(count * num_assets);
+    LinearAlgebra::gemm(count, num_assets, num_assets, weights, num_assets, cholesky_factor.data(), num_assets,
+                        transposed.data(), num_assets, false, num_threads);
+    loadings.resize(num_assets * count);
+    for (std::size_t p = 0; p < count; ++p) {
+        for (std::size_t i = 0; i < num_assets; ++i) {
+            loadings[i * count + p] = transposed[p * num_assets + i];
+        }
+    }
+
+    means.assign(count, 0.0);
+    for (std::size_t p = 0; p < count; ++p) {
+        for (std::size_t i = 0; i < num_assets; ++i) {
+            means[p] += weights[p * num_assets + i] * expected_returns[i];
+        }
+    }
+}
+
+std::vector<RiskCalculator::RiskMetrics> RiskCalculator::monteCarloRisk(const boost::numeric::ublas::matrix<double>& portfolios,
+                                                                        const SimulationSettings& settings) const {
+    QPO_SCOPED_TIMER("RiskCalculator::monteCarloRisk");
+    if (settings.scenarios == 0 || settings.blockSize == 0 || settings.horizonSteps == 0) {
+        throw std::invalid_argument("Scenario count, block size and horizon steps must be positive.");
+    }
+    if (settings.confidence <= 0.0 || settings.confidence >= 1.0) {
+        throw std::invalid_argument("Confidence must lie strictly between 0 and 1.");
+    }
+    if (settings.replications == 0 || settings.scenarios < settings.replications) {
+        throw std::invalid_argument("Each replication needs at least one scenario.");
+    }
+    if (settings.scenarios % settings.replications != 0) {
+        throw std::invalid_argument("Scenario count must be a multiple of the replication count.");
+    }
+    if (settings.controlVariate && settings.replications < 3) {
+        throw std::invalid_argument("Control variates need at least three replications.");
+    }
+
+    const std::size_t count = portfolios.size1();
+    if (count == 0) {
+        return {};
+    }
+    std::vector<double> loadings;
+    std::vector<double> means;
+    loadingsAndMeans(portfolios, loadings, means);
+
+    const std::size_t replications = settings.replications;
+    const std::size_t scenariosPerReplication = settings.scenarios / replications;
+    std::vector<ReplicationEstimate> estimates;
+    ReplicationProgress progress;
+
+    // Everything that determines the scenarios and estimates; a checkpoint of another run is rejected
+    std::vector<double> identity = {static_cast<double>(count), static_cast<double>(num_assets),
+                                    static_cast<double>(settings.scenarios), static_cast<double>(settings.blockSize),
+                                    settings.confidence, static_cast<double>(settings.seed),
+                                    static_cast<double>(static_cast<int>(settings.sampling)),
+                                    static_cast<double>(settings.horizonSteps),
+                                    static_cast<double>(static_cast<int>(settings.pathConstruction)),
+                                    static_cast<double>(settings.antithetic), static_cast<double>(replications)};
+    identity.insert(identity.end(), loadings.begin(), loadings.end());
+    identity.insert(identity.end(), means.begin(), means.end());
+    const std::uint64_t runFingerprint = Checkpoint::fingerprint(identity.data(), identity.size());
+
+    Checkpoint saved;
+    if (!settings.checkpointPath.empty() && saved.load(settings.checkpointPath)) {
+        if (saved.getUnsigned("mc.fingerprint") != runFingerprint) {
+            throw std::invalid_argument("Checkpoint was written by a different Monte Carlo run.");
+        }
+        const std::size_t done = saved.getUnsigned("mc.replications");
+        for (std::size_t k = 0; k < done; ++k) {
+            const std::string prefix = "mc." + std::to_string(k) + ".";
+            ReplicationEstimate estimate;
+            estimate.valueAtRisk = saved.getDoubles(prefix + "var");
+            estimate.conditionalValueAtRisk = saved.getDoubles(prefix + "cvar");
+            estimate.shiftedMean = saved.getDoubles(prefix + "mean");
+            estimate.shiftedSecondMoment = saved.getDoubles(prefix + "second");
+            estimates.push_back(estimate);
+        }
+        progress.nextBlock = saved.getUnsigned("mc.nextBlock");
+        if (progress.nextBlock > 0) {
+            progress.sums = saved.getDoubles("mc.sums");
+            progress.squares = saved.getDoubles("mc.squares");
+            for (std::size_t p = 0; p < count; ++p) {
+                progress.tails.push_back(saved.getDoubles("mc.tail." + std::to_string(p)));
+            }
+        }
+    }
+    std::unique_ptr<CheckpointWriter> writer;
+    if (!settings.checkpointPath.empty()) {
+        writer = std::make_unique<CheckpointWriter>(settings.checkpointPath);
+    }
+
+    auto snapshot = [&]() {
+        Checkpoint checkpoint;
+        checkpoint.setValue("mc.fingerprint", runFingerprint);
+        checkpoint.setValue("mc.replications", static_cast<std::uint64_t>(estimates.size()));
+        for (std::size_t k = 0; k < estimates.size(); ++k) {
+            const std::string prefix = "mc." + std::to_string(k) + ".";
+            checkpoint.setValues(prefix + "var", estimates[k].valueAtRisk);
+            checkpoint.setValues(prefix + "cvar", estimates[k].conditionalValueAtRisk);
+            checkpoint.setValues(prefix + "mean", estimates[k].shiftedMean);
+            checkpoint.setValues(prefix + "second", estimates[k].shiftedSecondMoment);
+        }
+        checkpoint.setValue("mc.nextBlock", static_cast<std::uint64_t>(progress.nextBlock));
+        if (progress.nextBlock > 0) {
+            checkpoint.setValues("mc.sums", progress.sums);
+            checkpoint.setValues("mc.squares", progress.squares);
+            for (std::size_t p = 0; p < count; ++p) {
+                checkpoint.setValues("mc.tail." + std::to_string(p), progress.tails[p]);
+            }
+        }
+        return checkpoint;
+    };
+    const std::size_t firstReplication = estimates.size();
+    std::size_t startBlock = progress.nextBlock;
+    std::function<void()> onSegment;
+    if (writer) {
+        onSegment = [&]() {
+            writer->maybeCheckpoint(progress.nextBlock, startBlock, settings.checkpointBlocks, snapshot,
+                                    "Monte Carlo run stopped before block");
+        };
+    }
+
+    for (std::size_t replication = firstReplication; replication < replications; ++replication) {
+        estimates.push_back(simulateReplication(settings, replication, scenariosPerReplication, num_assets,
+                                                loadings, means, progress, onSegment));
+        progress = ReplicationProgress();
+        startBlock = 0;
+        if (writer && replication + 1 < replications) {
+            writer->maybeCheckpoint(replication + 1, firstReplication, 1, snapshot, "Monte Carlo run stopped before replication");
+        }
+    }
+    if (writer) {
+        writer->finish(snapshot());
+    }
+    QPO_COUNTER("RiskCalculator::monteCarloRisk.scenarios", settings.scenarios * count);
+
+    std::vector<RiskMetrics> results(count);
+    std::vector<double> values(replications);
+    std::vector<double> controls(replications);
+    for (std::size_t p = 0; p < count; ++p) {
+        RiskMetrics& metrics = results[p];
+        double shiftedMean = 0.0;
+        for (std::size_t k = 0; k < replications; ++k) {
+            shiftedMean += estimates[k].shiftedMean[p] / static_cast<double>(replications);
+            controls[k] = estimates[k].shiftedSecondMoment[p];
+        }
+
+        // The second moment about the analytic mean has expectation w^T Sigma w = |L^T w|^2
+        double analyticVariance = 0.0;
+        for (std::size_t i = 0; i < num_assets; ++i) {
+            analyticVariance += loadings[i * count + p] * loadings[i * count + p];
+        }
+        double shiftedSecond = 0.0;
+        double ignored = 0.0;
+        combineReplications(controls, controls, analyticVariance, false, shiftedSecond, ignored);
+        metrics.expectedPnL = means[p] + shiftedMean;
+        metrics.volatility = std::sqrt(std::max(0.0, shiftedSecond - shiftedMean * shiftedMean));
+
+        for (std::size_t k = 0; k < replications; ++k) values[k] = estimates[k].valueAtRisk[p];
+        combineReplications(values, controls, analyticVariance, settings.controlVariate,
+                            metrics.valueAtRisk, metrics.valueAtRiskStandardError);
+        for (std::size_t k = 0; k < replications; ++k) values[k] = estimates[k].conditionalValueAtRisk[p];
+        combineReplications(values, controls, analyticVariance, settings.controlVariate,
+                            metrics.conditionalValueAtRisk, metrics.conditionalValueAtRiskStandardError);
+    }
+    return results;
+}
+
+std::vector<RiskCalculator::ConvergencePoint> RiskCalculator::convergenceReport(const boost::numeric::ublas::matrix<double>& portfolios,
+                                                                                const SimulationSettings& settings,
+                                                                                const std::vector<std::size_t>& scenarioCounts) const {
+    std::vector<ConvergencePoint> report;
+    SimulationSettings pointSettings = settings;
+    for (std::size_t scenarios : scenarioCounts) {
+        pointSettings.scenarios = scenarios;
+        if (!settings.checkpointPath.empty()) {
+            pointSettings.checkpointPath = settings.checkpointPath + "." + std::to_string(scenarios); // One run per file
+        }
+        ConvergencePoint point;
+        point.scenarios = scenarios;
+        point.metrics = monteCarloRisk(portfolios, pointSettings);
+        report.push_back(point);
+    }
+    return report;
+}
+
+void RiskCalculator::writeConvergenceCSV(const std::vector<ConvergencePoint>& report, std::ostream& out) {
+    out << "scenarios,portfolio,expected_pnl,volatility,var,var_standard_error,cvar,cvar_standard_error\n";
+    out << std::setprecision(10);
+    for (const ConvergencePoint& point : report) {
+        for (std::size_t p = 0; p < point.metrics.size(); ++p) {
+            const RiskMetrics& m = point.metrics[p];
+            out << point.scenarios << ',' << p << ',' << m.expectedPnL << ',' << m.volatility << ','
+                << m.valueAtRisk << ',' << m.valueAtRiskStandardError << ','
+                << m.conditionalValueAtRisk << ',' << m.conditionalValueAtRiskStandardError << '\n';
+        }
+    }
+}
+
+std::vector<RiskCalculator::RiskMetrics> RiskCalculator::analyticRisk(const boost::numeric::ublas::matrix<double>& portfolios,
+                                                                      double confidence) const {
+    if (portfolios.size2() != num_assets) {
+        throw std::invalid_argument("Portfolio weights must have one column per asset.");
+    }
+    if (portfolios.size1() == 0) {
+        return {};
+    }
+    boost::math::normal standardNormal;
+    const double z = boost::math::quantile(standardNormal, confidence);
+    const double tailDensity = boost::math::pdf(standardNormal, z) / (1.0 - confidence);
+
+    const double* weights = &portfolios.data()[0];
+    std::vector<RiskMetrics> results(portfolios.size1());
+    std::vector<double> sigmaW(num_assets);
+    for (std::size_t p = 0; p < portfolios.size1(); ++p) {
+        const double* w = weights + p * num_assets;
+        LinearAlgebra::gemm(num_assets, 1, num_assets, covariance.data(), num_assets, w, 1, sigmaW.data(), 1);
+        double mean = 0.0;
+        double variance = 0.0;
+        for (std::size_t i = 0; i < num_assets; ++i) {
+            mean += w[i] * expected_returns[i];
+            variance += w[i] * sigmaW[i];
+        }
+        RiskMetrics& metrics = results[p];
+        metrics.expectedPnL = mean;
+        metrics.volatility = std::sqrt(std::max(0.0, variance));
+        metrics.valueAtRisk = -mean + z * metrics.volatility;
+        metrics.conditionalValueAtRisk = -mean + tailDensity * metrics.volatility;
+    }
+    return results;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#ifndef RISK_CALCULATOR_HPP
+#define RISK_CALCULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>  // Boost matrix for covariance and portfolio weights
+
+/**
+ * @class RiskCalculator
+ * @brief Monte Carlo portfolio risk engine computing VaR and CVaR for many portfolios at once.
+ *
+ * The covariance is Cholesky-factorized once (Sigma = L * L^T) at construction. A scenario of asset
+ * returns is r = mu + L * z with z standard normal, so the P&L of portfolio w is w^T mu + (L^T w)^T z.
+ * The engine therefore precomputes B = L^T * W^T for all candidate portfolios and, for each block of
+ * scenarios, evaluates every portfolio's P&L with a single GEMM Z_block * B; the correlated returns
+ * themselves are never materialised.
+ *
+ * Scenarios are produced in fixed-size blocks, each from its own counter-seeded random stream, so the
+ * result does not depend on the number of threads. Each thread keeps only the worst losses needed for
+ * the tail (k = ceil((1 - confidence) * scenarios) per portfolio), trimmed with partial sorts after every
+ * block, which bounds memory independently of the scenario count.
+ *
+ * Variance reduction: the normals can come from a (digitally scrambled) Sobol sequence instead of the
+ * pseudo-random streams, optionally spread over several horizon steps with Brownian-bridge ordering so
+ * the best-distributed Sobol coordinates drive the terminal value; antithetic pairs (z, -z) halve the
+ * GEMM work per scenario; and with several independent replications the analytic portfolio variance
+ * w^T Sigma w serves as a control variate for the VaR and CVaR estimates.
+ *
+ * Long runs can be checkpointed: the finished replications and the running moments and tails of the
+ * current one are saved at block boundaries on a background thread, and a resumed run continues with
+ * the next block and returns bit for bit what the uninterrupted run would have.
+ */
+class RiskCalculator {
+public:
+    /// Source of the standard normal draws.
+    enum class SamplingMethod {
+        PseudoRandom,   ///< Independent xoshiro256** streams per block.
+        Sobol,          ///< Joe-Kuo Sobol sequence; replications use disjoint stretches of it.
+        ScrambledSobol  ///< Sobol sequence with an independent random digital shift per replication.
+    };
+
+    /// How the draws of one scenario are mapped onto the horizon steps (quasi-random sampling only).
+    enum class PathConstruction {
+        Incremental,    ///< Coordinate block s is the increment of step s.
+        BrownianBridge  ///< The first coordinates fix the terminal value, later ones fill in midpoints.
+    };
+
+    /**
+     * @brief Parameters of a Monte Carlo risk run.
+     */
+    struct SimulationSettings {
+        std::size_t scenarios = 1000000; ///< Total number of scenarios, a multiple of replications.
+        std::size_t blockSize = 1024;    ///< Scenarios generated and evaluated per block.
+        double confidence = 0.99;        ///< Confidence level of VaR and CVaR.
+        std::uint64_t seed = 42;         ///< Seed of the scenario streams (and of the Sobol scrambling).
+        int numThreads = 0;              ///< Worker threads, 0 to use every hardware thread.
+        SamplingMethod sampling = SamplingMethod::PseudoRandom; ///< Source of the normal draws.
+        std::size_t horizonSteps = 1;    ///< Steps the horizon is divided into for quasi-random path construction.
+        PathConstruction pathConstruction = PathConstruction::BrownianBridge; ///< Ordering of the Sobol coordinates.
+        bool antithetic = false;         ///< Evaluate every draw z together with its mirror -z.
+        std::size_t replications = 1;    ///< Independent replications used for standard errors.
+        bool controlVariate = false;     ///< Correct the estimates with the analytic variance (needs >= 3 replications).
+        std::string checkpointPath;      ///< Checkpoint file, empty to disable; a checkpoint of the same run is resumed from.
+        std::size_t checkpointBlocks = 0; ///< Blocks between checkpoints, 0 to checkpoint once per replication; stop requests are polled more often.
+    };
+
+    /**
+     * @brief Risk figures for a single portfolio, expressed as losses (positive numbers are losses).
+     */
+    struct RiskMetrics {
+        double expectedPnL = 0.0;            ///< Mean P&L over all scenarios.
+        double volatility = 0.0;             ///< Standard deviation of the P&L.
+        double valueAtRisk = 0.0;            ///< Loss exceeded with probability (1 - confidence).
+        double conditionalValueAtRisk = 0.0; ///< Mean loss beyond the VaR (expected shortfall).
+        double valueAtRiskStandardError = 0.0;            ///< Standard error of the VaR across replications.
+        double conditionalValueAtRiskStandardError = 0.0; ///< Standard error of the CVaR across replications.
+    };
+
+    /**
+     * @brief Estimates obtained at one scenario count of a convergence study.
+     */
+    struct ConvergencePoint {
+        std::size_t scenarios = 0;        ///< Scenario count of this row.
+        std::vector<RiskMetrics> metrics; ///< One entry per portfolio.
+    };
+
+    /**
+     * @brief Constructor for the RiskCalculator class.
+     *
+     * @param expectedReturns Expected return of each asset over the risk horizon.
+     * @param covariance Covariance matrix of the asset returns over the same horizon.
+     * @param numThreads Threads used for the factorization, 0 to use every hardware thread.
+     * @throws std::invalid_argument if the dimensions disagree or the covariance is not positive definite.
+     */
+    RiskCalculator(const std::vector<double>& expectedReturns, const boost::numeric::ublas::matrix<double>& covariance,
+                   int numThreads = 0);
+
+    /**
+     * @brief Simulates correlated return scenarios and computes risk figures for every portfolio.
+     *
+     * @param portfolios Matrix with one portfolio per row and one column per asset (holdings or weights).
+     * @param settings Scenario count, block size, confidence, seed, thread count and variance reduction.
+     * @return One RiskMetrics entry per portfolio row; standard errors are zero with a single replication.
+     * @throws std::invalid_argument for inconsistent settings, e.g. a control variate with fewer than 3 replications
+     *         or a scenario count that is not a multiple of the replication count.
+     */
+    std::vector<RiskMetrics> monteCarloRisk(const boost::numeric::ublas::matrix<double>& portfolios,
+                                            const SimulationSettings& settings) const;
+
+    /**
+     * @brief Runs the estimator at increasing scenario counts to show how estimates and errors converge.
+     *
+     * @param portfolios Matrix with one portfolio per row and one column per asset.
+     * @param settings Settings shared by every row; the scenario count is replaced by each entry of scenarioCounts
+     *                 and a checkpoint path gets the scenario count appended.
+     * @param scenarioCounts Scenario counts to evaluate, typically doubling.
+     * @return One ConvergencePoint per scenario count.
+     */
+    std::vector<ConvergencePoint> convergenceReport(const boost::numeric::ublas::matrix<double>& portfolios,
+                                                    const SimulationSettings& settings,
+                                                    const std::vector<std::size_t>& scenarioCounts) const;
+
+    /**
+     * @brief Writes a convergence report as CSV, one row per scenario count and portfolio.
+     */
+    static void writeConvergenceCSV(const std::vector<ConvergencePoint>& report, std::ostream& out);
+
+    /**
+     * @brief Closed-form risk figures under the same Gaussian model, for validation and control variates.
+     */
+    std::vector<RiskMetrics> analyticRisk(const boost::numeric::ublas::matrix<double>& portfolios, double confidence) const;
+
+    /**
+     * @brief Number of assets in the universe.
+     */
+    std::size_t numAssets() const { return num_assets; }
+
+    /**
+     * @brief Lower-triangular Cholesky factor of the covariance, row-major.
+     */
+    const std::vector<double>& choleskyFactor() const { return cholesky_factor; }
+
+private:
+    std::size_t num_assets;               ///< Number of assets.
+    std::vector<double> expected_returns; ///< Expected return per asset.
+    std::vector<double> covariance;       ///< Covariance matrix, row-major.
+    std::vector<double> cholesky_factor;  ///< Lower Cholesky factor of the covariance, row-major.
+    int num_threads;                      ///< Threads used by the dense kernels.
+
+    /**
+     * @brief Computes B = L^T * W^T (assets x portfolios) and the expected P&L w^T mu of every portfolio.
+     */
+    void loadingsAndMeans(const boost::numeric::ublas::matrix<double>& portfolios,
+                          std::vector<double>& loadings, std::vector<double>& means) const;
+};
+
+#endif // RISK_CALCULATOR_HPP
@@ -0,0 +1,118 @@
+#include "WorkStealingPool.hpp"
+#include "Parallel.hpp"
+
+namespace {
+
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local int currentIndex = -1;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int numThreads)
+    : queued(0), pending(0), next_queue(0), stopping(false) {
+    const int threads = Parallel::threadCount(numThreads);
+    for (int t = 0; t < threads; ++t) {
+        queues.emplace_back(new Queue());
+    }
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([this, t]() { workerLoop(t); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        all_done.wait(lock, [this]() { return pending.load() == 0; });
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int WorkStealingPool::currentWorker() {
+    return currentIndex;
+}
+
+void WorkStealingPool::submit(Task task) {
+    pending.fetch_add(1);
+    const std::size_t target = currentPool == this ? static_cast<std::size_t>(currentIndex)
+                                                   : next_queue.fetch_add(1) % queues.size();
+    {
+        // Counted before the push (so takes never underflow) and under the state mutex (so a worker
+        // cannot miss the wake-up between its check and its wait)
+        std::lock_guard<std::mutex> lock(state_mutex);
+        queued.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    work_available.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        all_done.wait(lock, [this]() { return pending.load() == 0; });
+        std::swap(error, first_error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool WorkStealingPool::tryTake(int index, Task& task) {
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    const std::size_t count = queues.size();
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        Queue& victim = *queues[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int index) {
+    currentPool = this;
+    currentIndex = index;
+    Task task;
+    while (true) {
+        if (tryTake(index, task)) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                if (!first_error) first_error = std::current_exception();
+            }
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                all_done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex);
+        work_available.wait(lock, [this]() { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
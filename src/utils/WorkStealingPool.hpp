@@ -0,0 +1,96 @@
+#pragma once
+
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool in which idle workers steal queued tasks from busy ones.
+ *
+ * Every worker owns a task deque. Tasks submitted from a worker go to the back of its own deque and are
+ * popped from the back (LIFO, cache-warm); tasks submitted from outside are dealt round-robin. A worker
+ * whose deque is empty steals from the front of the other deques, so long-running tasks do not leave
+ * cores idle while short ones wait behind them.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Starts the workers.
+     *
+     * @param numThreads Number of workers, 0 to use every hardware thread.
+     */
+    explicit WorkStealingPool(int numThreads = 0);
+
+    /**
+     * @brief Finishes the queued tasks and joins the workers.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queues a task; it may be called from inside a running task.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Blocks until every submitted task (including tasks they submitted) has finished.
+     *
+     * Must not be called from a task. Rethrows the first exception thrown by a task, if any.
+     */
+    void wait();
+
+    /**
+     * @brief Number of worker threads.
+     */
+    int size() const { return static_cast<int>(workers.size()); }
+
+    /**
+     * @brief Index of the calling worker in its pool, or -1 when called from outside any pool.
+     */
+    static int currentWorker();
+
+private:
+    /// Task deque owned by one worker.
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; ///< One deque per worker.
+    std::vector<std::thread> workers;           ///< Worker threads.
+    std::atomic<std::size_t> queued;            ///< Tasks sitting in a deque.
+    std::atomic<std::size_t> pending;           ///< Tasks submitted but not yet finished.
+    std::atomic<std::size_t> next_queue;        ///< Round-robin cursor for external submissions.
+    std::mutex state_mutex;                     ///< Guards sleeping, waking and the stored exception.
+    std::condition_variable work_available;     ///< Signalled when a task is queued or the pool stops.
+    std::condition_variable all_done;           ///< Signalled when pending drops to zero.
+    std::exception_ptr first_error;             ///< First exception escaping a task.
+    bool stopping;                              ///< Set by the destructor.
+
+    /**
+     * @brief Main loop of worker index: run own tasks, steal when empty, sleep when nothing is queued.
+     */
+    void workerLoop(int index);
+
+    /**
+     * @brief Takes a task from the back of the own deque or the front of another one.
+     */
+    bool tryTake(int index, Task& task);
+};
+
+#endif // WORK_STEALING_POOL_HPP
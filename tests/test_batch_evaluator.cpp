@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/utils/BatchEvaluator.hpp"
+
+namespace {
+
+// Random positive-definite covariance A * A^T / n + 0.01 * I
+boost::numeric::ublas::matrix<double> makeCovariance(std::size_t n, std::mt19937& rng) {
+    std::normal_distribution<double> normal(0.0, 0.1);
+    boost::numeric::ublas::matrix<double> a(n, n);
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j) a(i, j) = normal(rng);
+    boost::numeric::ublas::matrix<double> covariance(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            double sum = 0.0;
+            for (std::size_t p = 0; p < n; ++p) sum += a(i, p) * a(j, p);
+            covariance(i, j) = sum / n + (i == j ? 0.01 : 0.0);
+        }
+    }
+    return covariance;
+}
+
+} // namespace
+
+TEST(BatchEvaluatorTest, MatchesDirectQuadraticForm) {
+    std::mt19937 rng(7);
+    const std::size_t n = 37;
+    const std::size_t rows = 150;  // Not a multiple of the internal block size
+    auto covariance = makeCovariance(n, rng);
+    std::vector<double> mu(n);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (double& m : mu) m = 0.1 * uniform(rng);
+
+    boost::numeric::ublas::matrix<double> weights(rows, n);
+    for (std::size_t r = 0; r < rows; ++r)
+        for (std::size_t i = 0; i < n; ++i) weights(r, i) = uniform(rng) / n;
+
+    BatchEvaluator evaluator(mu, covariance, 0.01, 3);
+    auto doubles = evaluator.evaluate(weights);
+    auto singles = evaluator.evaluate(weights, BatchEvaluator::Precision::Single);
+    ASSERT_EQ(doubles.size(), rows);
+
+    for (std::size_t r = 0; r < rows; ++r) {
+        double variance = 0.0;
+        double expected = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            expected += weights(r, i) * mu[i];
+            for (std::size_t j = 0; j < n; ++j) variance += weights(r, i) * covariance(i, j) * weights(r, j);
+        }
+        ASSERT_NEAR(doubles[r].variance, variance, 1e-12);
+        ASSERT_NEAR(doubles[r].expectedReturn, expected, 1e-12);
+        ASSERT_NEAR(doubles[r].sharpeRatio, (expected - 0.01) / std::sqrt(variance), 1e-9);
+        ASSERT_NEAR(singles[r].variance, variance, 1e-5 * variance);
+    }
+}
+
+TEST(BatchEvaluatorTest, ReportsConstraintViolations) {
+    boost::numeric::ublas::identity_matrix<double> identity(3);
+    BatchEvaluator evaluator({0.05, 0.06, 0.07}, boost::numeric::ublas::matrix<double>(identity));
+    BatchEvaluator::Constraints constraints;
+    constraints.minWeight = 0.0;
+    constraints.maxWeight = 0.6;
+    constraints.maxHoldings = 2;
+    evaluator.setConstraints(constraints);
+
+    boost::numeric::ublas::matrix<double> weights(3, 3);
+    weights(0, 0) = 0.5; weights(0, 1) = 0.5; weights(0, 2) = 0.0;  // Feasible
+    weights(1, 0) = 0.8; weights(1, 1) = -0.1; weights(1, 2) = 0.5; // Bounds, budget and holdings
+    weights(2, 0) = 0.0; weights(2, 1) = 0.0; weights(2, 2) = 0.0;  // Riskless, misses the budget
+    auto results = evaluator.evaluate(weights);
+
+    ASSERT_TRUE(results[0].feasible);
+    ASSERT_FALSE(results[1].feasible);
+    ASSERT_NEAR(results[1].boundViolation, 0.3, 1e-12);
+    ASSERT_NEAR(results[1].budgetViolation, 0.2 - 1e-6, 1e-12);
+    ASSERT_EQ(results[1].holdingsViolation, 1u);
+    ASSERT_FALSE(results[2].feasible);
+    ASSERT_DOUBLE_EQ(results[2].sharpeRatio, 0.0);
+}
+
+TEST(BatchEvaluatorTest, EqualWeightsFromSelections) {
+    auto weights = BatchEvaluator::equalWeights({{1, 0, 1, 1}, {0, 0, 0, 0}});
+    ASSERT_EQ(weights.size1(), 2u);
+    ASSERT_DOUBLE_EQ(weights(0, 0), 1.0 / 3.0);
+    ASSERT_DOUBLE_EQ(weights(0, 1), 0.0);
+    ASSERT_DOUBLE_EQ(weights(1, 2), 0.0);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <boost/numeric/ublas/lu.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/classical_algorithms/BlackLitterman.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+namespace {
+
+ublas::matrix<double> makeCovariance() {
+    ublas::matrix<double> covariance(4, 4);
+    const double values[4][4] = {{0.04, 0.006, 0.002, 0.001},
+                                 {0.006, 0.09, 0.009, 0.003},
+                                 {0.002, 0.009, 0.0625, 0.004},
+                                 {0.001, 0.003, 0.004, 0.01}};
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j) covariance(i, j) = values[i][j];
+    return covariance;
+}
+
+// Reference only: explicit inverse through an LU factorization
+ublas::matrix<double> inverse(ublas::matrix<double> a) {
+    ublas::permutation_matrix<std::size_t> pivots(a.size1());
+    ublas::lu_factorize(a, pivots);
+    ublas::matrix<double> result = ublas::identity_matrix<double>(a.size1());
+    ublas::lu_substitute(a, pivots, result);
+    return result;
+}
+
+BlackLitterman::Views makeViews() {
+    BlackLitterman::Views views;
+    views.pick = ublas::zero_matrix<double>(2, 4);
+    views.pick(0, 0) = 1.0;                           // Absolute view on asset 0
+    views.pick(1, 1) = 1.0; views.pick(1, 2) = -1.0;  // Asset 1 outperforms asset 2
+    views.returns = {0.08, 0.02};
+    views.variances = {0.001, 0.002};
+    return views;
+}
+
+} // namespace
+
+TEST(BlackLittermanTest, MatchesPrecisionFormWithoutRefactorizing) {
+    const double tau = 0.05;
+    const double delta = 2.5;
+    auto sigma = makeCovariance();
+    FactorizationCache cache;
+    cache.setCovariance(sigma);
+    BlackLitterman model(cache, tau, delta);
+
+    auto prior = model.impliedReturns({0.3, 0.3, 0.2, 0.2});
+    auto views = makeViews();
+    auto result = model.posterior(prior, views, true);
+
+    // mu = [(tau Sigma)^-1 + P^T Omega^-1 P]^-1 [(tau Sigma)^-1 pi + P^T Omega^-1 q]
+    ublas::matrix<double> tauSigmaInv = inverse(tau * sigma);
+    ublas::matrix<double> omegaInv = ublas::zero_matrix<double>(2, 2);
+    omegaInv(0, 0) = 1.0 / views.variances[0];
+    omegaInv(1, 1) = 1.0 / views.variances[1];
+    ublas::matrix<double> ptOmegaInv = ublas::prod(ublas::trans(views.pick), omegaInv);
+    ublas::matrix<double> precision = tauSigmaInv + ublas::prod(ptOmegaInv, views.pick);
+    ublas::vector<double> pi(4), q(2);
+    for (int i = 0; i < 4; ++i) pi(i) = prior[i];
+    q(0) = views.returns[0];
+    q(1) = views.returns[1];
+    ublas::vector<double> rhs = ublas::prod(tauSigmaInv, pi) + ublas::prod(ptOmegaInv, q);
+    ublas::matrix<double> meanCovariance = inverse(precision);
+    ublas::vector<double> expected = ublas::prod(meanCovariance, rhs);
+    ublas::matrix<double> posteriorCovariance = sigma + meanCovariance;
+    ublas::matrix<double> scaled = delta * posteriorCovariance;
+    ublas::vector<double> expectedWeights = ublas::prod(inverse(scaled), expected);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NEAR(result.posteriorReturns[i], expected(i), 1e-10);
+        ASSERT_NEAR(result.weights[i], expectedWeights(i), 1e-8);
+        for (int j = 0; j < 4; ++j) {
+            ASSERT_NEAR(result.posteriorCovariance(i, j), posteriorCovariance(i, j), 1e-12);
+        }
+    }
+
+    // Tweaking the views reuses the cached factor of Sigma
+    views.returns[0] = 0.1;
+    model.posterior(prior, views);
+    ASSERT_EQ(cache.factorizations(), 1u);
+    cache.setCovariance(sigma);
+    model.posterior(prior, views);
+    ASSERT_EQ(cache.factorizations(), 2u);
+}
+
+TEST(BlackLittermanTest, NoViewsKeepsPrior) {
+    FactorizationCache cache;
+    cache.setCovariance(makeCovariance());
+    BlackLitterman model(cache);
+    std::vector<double> market = {0.25, 0.25, 0.25, 0.25};
+    auto prior = model.impliedReturns(market);
+
+    BlackLitterman::Views views;
+    auto result = model.posterior(prior, views);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_DOUBLE_EQ(result.posteriorReturns[i], prior[i]);
+        ASSERT_NEAR(result.weights[i], market[i] / 1.05, 1e-12);  // Sigma_BL = (1 + tau) Sigma
+    }
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/utils/Checkpoint.hpp"
+
+TEST(CheckpointTest, RoundTripsValuesBitForBit) {
+    const char* path = "test_checkpoint_values.ckpt";
+    std::mt19937 engine(7);
+    engine.discard(1000);
+    const std::vector<double> values = {0.1, -0.0, 1e-310, std::numeric_limits<double>::infinity(), -123.456};
+
+    Checkpoint checkpoint;
+    checkpoint.setValue("pi", 3.141592653589793);
+    checkpoint.setValue("count", static_cast<std::uint64_t>(1) << 60);
+    checkpoint.setValues("values", values);
+    checkpoint.setValues("bits", std::vector<int>{1, 0, 1, 1});
+    checkpoint.setEngine("rng", engine);
+    checkpoint.save(path);
+
+    Checkpoint loaded;
+    ASSERT_TRUE(loaded.load(path));
+    std::remove(path);
+    ASSERT_EQ(loaded.getDouble("pi"), 3.141592653589793);
+    ASSERT_EQ(loaded.getUnsigned("count"), static_cast<std::uint64_t>(1) << 60);
+    auto restored = loaded.getDoubles("values");
+    ASSERT_EQ(restored.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(std::signbit(restored[i]), std::signbit(values[i]));
+        ASSERT_EQ(restored[i], values[i]);
+    }
+    ASSERT_EQ(loaded.getInts("bits"), (std::vector<int>{1, 0, 1, 1}));
+
+    std::mt19937 resumed;
+    loaded.getEngine("rng", resumed);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(resumed(), engine());
+    }
+    ASSERT_FALSE(loaded.has("missing"));
+    ASSERT_THROW(loaded.getDouble("missing"), std::runtime_error);
+}
+
+TEST(CheckpointTest, RejectsMissingAndTruncatedFiles) {
+    Checkpoint checkpoint;
+    ASSERT_FALSE(checkpoint.load("test_checkpoint_does_not_exist.ckpt"));
+
+    const char* path = "test_checkpoint_truncated.ckpt";
+    Checkpoint complete;
+    complete.setValue("value", 1.0);
+    complete.setValues("values", std::vector<double>(64, 2.0));
+    complete.save(path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    for (std::size_t cut : {bytes.size() - 1, bytes.size() - 12, bytes.size() / 2}) {
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(cut)); // Cuts into the end record or an entry
+        }
+        ASSERT_THROW(checkpoint.load(path), std::runtime_error);
+    }
+    {
+        std::ofstream out(path);
+        out << "qpo-checkpoint 1\nvalue 3ff0000000000000\nend 1\n"; // The retired text format
+    }
+    ASSERT_THROW(checkpoint.load(path), std::runtime_error);
+    std::remove(path);
+    ASSERT_THROW(complete.getUnsigned("value"), std::runtime_error);
+    ASSERT_THROW(checkpoint.setValue("two words", 1.0), std::invalid_argument);
+}
+
+TEST(CheckpointTest, WriterLeavesTheLatestSnapshot) {
+    const char* path = "test_checkpoint_writer.ckpt";
+    {
+        CheckpointWriter writer(path);
+        for (std::uint64_t i = 1; i <= 200; ++i) {
+            Checkpoint checkpoint;
+            checkpoint.setValue("step", i);
+            writer.submit(checkpoint);
+        }
+        writer.flush();
+        ASSERT_GE(writer.written(), 1u);
+        ASSERT_LE(writer.written(), 200u);
+    }
+    Checkpoint loaded;
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(loaded.getUnsigned("step"), 200u);
+    ASSERT_FALSE(std::ifstream(std::string(path) + ".tmp").good());
+    std::remove(path);
+}
+
+TEST(CheckpointTest, StopIsHonouredWithoutPeriodicCheckpoints) {
+    const char* path = "test_checkpoint_boundary.ckpt";
+    std::remove(path);
+    CheckpointWriter writer(path);
+    int snapshots = 0;
+    auto snapshot = [&snapshots]() {
+        ++snapshots;
+        return Checkpoint();
+    };
+
+    // Interval 0: nothing is written until a stop is requested
+    for (std::size_t step = 3; step < 50; ++step) {
+        writer.maybeCheckpoint(step, 3, 0, snapshot, "Loop stopped at step");
+    }
+    ASSERT_EQ(snapshots, 0);
+
+    Checkpoint::requestStop();
+    writer.maybeCheckpoint(3, 3, 0, snapshot, "Loop stopped at step"); // No step made yet: keep going
+    ASSERT_EQ(snapshots, 0);
+    try {
+        writer.maybeCheckpoint(50, 3, 0, snapshot, "Loop stopped at step");
+        Checkpoint::clearStop();
+        FAIL() << "Expected CheckpointInterrupted";
+    } catch (const CheckpointInterrupted& ex) {
+        Checkpoint::clearStop();
+        ASSERT_STREQ(ex.what(), "Loop stopped at step 50.");
+    }
+    ASSERT_EQ(snapshots, 1);
+    ASSERT_EQ(writer.written(), 1u); // On disk before the exception was thrown
+    std::remove(path);
+}
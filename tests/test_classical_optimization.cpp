@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
 #include "../src/classical_algorithms/Optimization.hpp"
+#include "../src/utils/Checkpoint.hpp"
 
 TEST(ClassicalOptimizationTest, GradientDescentConvergence) {
     // Define a simple quadratic cost function: f(x) = (x1^2 + x2^2)
@@ -48,3 +52,77 @@ TEST(ClassicalOptimizationTest, SimulatedAnnealingOptimization) {
         ASSERT_EQ(bit, 0);
     }
 }
+
+TEST(ClassicalOptimizationTest, SimulatedAnnealingResumesBitForBit) {
+    const char* path = "test_annealing_resume.ckpt";
+    std::remove(path);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+    std::vector<double> weights(24 * 24);
+    for (double& w : weights) w = coefficient(rng);
+    int calls = 0;
+    int stopAt = 0;
+    auto energyFunction = [&weights, &calls, &stopAt](const std::vector<int>& state) {
+        if (++calls == stopAt) {
+            Checkpoint::requestStop();
+        }
+        double energy = 0.0;
+        for (size_t i = 0; i < state.size(); ++i) {
+            for (size_t j = 0; j < state.size(); ++j) energy += weights[i * state.size() + j] * state[i] * state[j];
+        }
+        return energy;
+    };
+    const std::vector<int> initialState(24, 0);
+    auto reference = Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 11u);
+
+    // Preempted between two periodic checkpoints, then resumed
+    Optimization::CheckpointSettings checkpoint;
+    checkpoint.path = path;
+    checkpoint.interval = 700;
+    calls = 0;
+    stopAt = 1200;
+    ASSERT_THROW(Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 11u, checkpoint),
+                 CheckpointInterrupted);
+    Checkpoint::clearStop();
+    stopAt = 0;
+    Checkpoint saved;
+    ASSERT_TRUE(saved.load(path));
+    ASSERT_EQ(saved.getUnsigned("sa.iteration"), 1199u);
+
+    auto resumed = Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 11u, checkpoint);
+    ASSERT_EQ(resumed, reference);
+    ASSERT_THROW(Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 12u, checkpoint),
+                 std::invalid_argument);
+    std::remove(path);
+}
+
+TEST(ClassicalOptimizationTest, SimulatedAnnealingStopsWithoutPeriodicCheckpoints) {
+    const char* path = "test_annealing_stop.ckpt";
+    std::remove(path);
+    int calls = 0;
+    auto energyFunction = [&calls](const std::vector<int>& state) {
+        if (++calls == 1000) {
+            Checkpoint::requestStop(); // Preemption signal arriving mid-run
+        }
+        double energy = 0.0;
+        for (size_t i = 0; i < state.size(); ++i) energy += (i % 3 == 0 ? -1.0 : 0.5) * state[i] + 0.1 * state[i] * state[(i + 1) % state.size()];
+        return energy;
+    };
+    const std::vector<int> initialState(16, 0);
+    auto reference = Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 4u);
+    Checkpoint::clearStop();
+
+    Optimization::CheckpointSettings checkpoint;
+    checkpoint.path = path;  // interval 0: no periodic checkpoints
+    calls = 0;
+    ASSERT_THROW(Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 4u, checkpoint),
+                 CheckpointInterrupted);
+    Checkpoint::clearStop();
+    Checkpoint saved;
+    ASSERT_TRUE(saved.load(path));
+    ASSERT_EQ(saved.getUnsigned("sa.iteration"), 999u); // Call 1000 is iteration 998's move
+
+    auto resumed = Optimization::simulatedAnnealing(energyFunction, initialState, 5.0, 0.999, 3000, 4u, checkpoint);
+    ASSERT_EQ(resumed, reference);
+    std::remove(path);
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include "../src/utils/DataLoader.hpp"
+
+TEST(DataLoaderTest, LoadsLabelledCovariance) {
+    const char* path = "test_data_loader_covariance.csv";
+    {
+        std::ofstream out(path);
+        out << ",Asset_1,Asset_2\r\nAsset_1,0.04,0.01\r\nAsset_2,0.01,0.09\r\n";
+    }
+    auto covariance = DataLoader::loadCovariance(path);
+    std::remove(path);
+
+    ASSERT_EQ(covariance.size1(), 2u);
+    ASSERT_EQ(covariance.size2(), 2u);
+    ASSERT_DOUBLE_EQ(covariance(0, 1), 0.01);
+    ASSERT_DOUBLE_EQ(covariance(1, 1), 0.09);
+}
+
+TEST(DataLoaderTest, SampleStatisticsOfReturns) {
+    const char* path = "test_data_loader_returns.csv";
+    {
+        std::ofstream out(path);
+        out << "Asset_1,Asset_2\n0.01,0.02\n0.03,-0.02\n0.02,0.03\n";
+    }
+    auto returns = DataLoader::loadReturns(path);
+    std::remove(path);
+
+    ASSERT_EQ(returns.size1(), 3u);
+    auto means = DataLoader::meanReturns(returns);
+    ASSERT_NEAR(means[0], 0.02, 1e-15);
+    ASSERT_NEAR(means[1], 0.01, 1e-15);
+
+    auto covariance = DataLoader::sampleCovariance(returns);
+    ASSERT_NEAR(covariance(0, 0), 1e-4, 1e-15);
+    ASSERT_NEAR(covariance(0, 1), -2e-4, 1e-15);
+    ASSERT_DOUBLE_EQ(covariance(0, 1), covariance(1, 0));
+}
+
+TEST(DataLoaderTest, MissingFileThrows) {
+    ASSERT_THROW(DataLoader::loadReturns("does/not/exist.csv"), std::runtime_error);
+}
+
+TEST(DataLoaderTest, NonNumericCellThrows) {
+    const char* path = "test_data_loader_bad_returns.csv";
+    {
+        std::ofstream out(path);
+        out << "Asset_1,Asset_2\n0.01,0.02\n0.03,n/a\n";
+    }
+    try {
+        DataLoader::loadReturns(path);
+        std::remove(path);
+        FAIL() << "Expected std::runtime_error";
+    } catch (const std::runtime_error& ex) {
+        std::remove(path);
+        ASSERT_NE(std::string(ex.what()).find("row 3, column 2"), std::string::npos);
+    }
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/classical_algorithms/GeneticAlgorithm.hpp"
+
+namespace {
+
+boost::numeric::ublas::matrix<double> makeRandomQUBO(int size, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    boost::numeric::ublas::matrix<double> QUBO_matrix(size, size);
+    for (int i = 0; i < size; ++i)
+        for (int j = 0; j < size; ++j) QUBO_matrix(i, j) = dist(gen);
+    return QUBO_matrix;
+}
+
+double energy(const std::vector<int>& x, const boost::numeric::ublas::matrix<double>& Q) {
+    double e = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+        for (size_t j = 0; j < x.size(); ++j) e += Q(i, j) * x[i] * x[j];
+    return e;
+}
+
+} // namespace
+
+TEST(GeneticAlgorithmTest, QuboFitnessMatchesDirectEnergy) {
+    const int n = 70;  // Spans two words with a partial last word
+    auto Q = makeRandomQUBO(n, 3);
+    std::mt19937_64 gen(5);
+    const size_t count = 100;
+    std::vector<std::uint64_t> genomes(count * 2);
+    for (auto& word : genomes) word = gen();
+    for (size_t c = 0; c < count; ++c) genomes[c * 2 + 1] &= (std::uint64_t(1) << (n - 64)) - 1;
+
+    std::vector<double> doubles(count);
+    std::vector<double> singles(count);
+    GeneticAlgorithm::quboFitness(Q, 2)(genomes.data(), count, n, 2, doubles.data());
+    GeneticAlgorithm::quboFitness(Q, 2, true)(genomes.data(), count, n, 2, singles.data());
+    for (size_t c = 0; c < count; ++c) {
+        const double expected = energy(GeneticAlgorithm::decode(genomes.data() + c * 2, n), Q);
+        ASSERT_NEAR(doubles[c], expected, 1e-9);
+        ASSERT_NEAR(singles[c], expected, 1e-3);
+    }
+}
+
+TEST(GeneticAlgorithmTest, FindsExhaustiveOptimumAndIsThreadIndependent) {
+    const int n = 12;
+    auto Q = makeRandomQUBO(n, 11);
+    double optimum = 0.0;
+    std::vector<int> x(n);
+    for (int mask = 0; mask < (1 << n); ++mask) {
+        for (int k = 0; k < n; ++k) x[k] = (mask >> k) & 1;
+        optimum = std::min(optimum, energy(x, Q));
+    }
+
+    GeneticAlgorithm::Settings settings;
+    settings.populationSize = 600;
+    settings.generations = 60;
+    settings.numThreads = 1;
+    auto serial = GeneticAlgorithm(n, GeneticAlgorithm::quboFitness(Q, 1), settings).run();
+    settings.numThreads = 3;
+    settings.crossover = GeneticAlgorithm::Crossover::OnePoint;
+    auto onePoint = GeneticAlgorithm(n, GeneticAlgorithm::quboFitness(Q, 3), settings).run();
+    settings.crossover = GeneticAlgorithm::Crossover::Uniform;
+    auto threaded = GeneticAlgorithm(n, GeneticAlgorithm::quboFitness(Q, 3), settings).run();
+
+    ASSERT_NEAR(serial.fitness, optimum, 1e-9);
+    ASSERT_NEAR(onePoint.fitness, optimum, 1e-9);
+    ASSERT_NEAR(energy(serial.solution, Q), serial.fitness, 1e-9);
+    ASSERT_EQ(serial.solution, threaded.solution);
+    ASSERT_EQ(serial.bestFitness, threaded.bestFitness);
+    ASSERT_EQ(serial.bestFitness.size(), 61u);
+    for (size_t g = 1; g < serial.bestFitness.size(); ++g) {
+        ASSERT_LE(serial.bestFitness[g], serial.bestFitness[g - 1]);  // Elitism never loses the best
+    }
+}
+
+TEST(GeneticAlgorithmTest, MeanVarianceFitnessUsesEqualWeights) {
+    boost::numeric::ublas::matrix<double> covariance(3, 3, 0.0);
+    covariance(0, 0) = 0.04; covariance(1, 1) = 0.09; covariance(2, 2) = 0.01;
+    auto fitness = GeneticAlgorithm::meanVarianceFitness({0.1, 0.2, 0.05}, covariance, 2.0, 1);
+
+    std::vector<std::uint64_t> genomes = {0b011, 0b000};
+    std::vector<double> values(2);
+    fitness(genomes.data(), 2, 3, 1, values.data());
+    ASSERT_NEAR(values[0], 2.0 * (0.25 * 0.04 + 0.25 * 0.09) - 0.15, 1e-12);
+    ASSERT_DOUBLE_EQ(values[1], 0.0);
+}
+
+TEST(GeneticAlgorithmTest, RejectsInconsistentSettings) {
+    GeneticAlgorithm::Settings settings;
+    settings.elites = settings.populationSize;
+    auto fitness = GeneticAlgorithm::quboFitness(makeRandomQUBO(4, 1));
+    ASSERT_THROW(GeneticAlgorithm(4, fitness, settings), std::invalid_argument);
+}
+
+TEST(GeneticAlgorithmTest, RejectsFitnessOfAnotherDimension) {
+    GeneticAlgorithm::Settings settings;
+    settings.populationSize = 16;
+    settings.generations = 1;
+    boost::numeric::ublas::matrix<double> covariance(3, 3, 0.0);
+    covariance(0, 0) = covariance(1, 1) = covariance(2, 2) = 0.04;
+
+    GeneticAlgorithm longer(5, GeneticAlgorithm::quboFitness(makeRandomQUBO(4, 1), 1), settings);
+    ASSERT_THROW(longer.run(), std::invalid_argument);
+    GeneticAlgorithm shorter(2, GeneticAlgorithm::meanVarianceFitness({0.1, 0.2, 0.3}, covariance, 1.0, 1), settings);
+    ASSERT_THROW(shorter.run(), std::invalid_argument);
+}
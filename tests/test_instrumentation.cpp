@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "../src/utils/Instrumentation.hpp"
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+TEST(InstrumentationTest, TimersAndCountersReachTheLog) {
+    const std::string logPath = "test_instrumentation.log";
+    std::remove(logPath.c_str());
+    Instrumentation::reset();
+    Instrumentation::setLogFile(logPath);
+
+    {
+        QPO_SCOPED_TIMER("InstrumentationTest.scope");
+        QPO_COUNTER("InstrumentationTest.counter", 42);
+    }
+    std::thread worker([]() { QPO_COUNTER("InstrumentationTest.worker", 7); });
+    worker.join();
+    Instrumentation::flush();
+
+    std::string log = readFile(logPath);
+    ASSERT_NE(log.find("timer InstrumentationTest.scope duration_us="), std::string::npos);
+    ASSERT_NE(log.find("counter InstrumentationTest.counter value=42"), std::string::npos);
+    ASSERT_NE(log.find("counter InstrumentationTest.worker value=7"), std::string::npos);
+}
+
+TEST(InstrumentationTest, ChromeTraceExport) {
+    const std::string tracePath = "test_instrumentation_trace.json";
+    Instrumentation::reset();
+
+    {
+        QPO_SCOPED_TIMER("InstrumentationTest.traced");
+    }
+    ASSERT_TRUE(Instrumentation::exportChromeTrace(tracePath));
+
+    std::string trace = readFile(tracePath);
+    ASSERT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    ASSERT_NE(trace.find("\"name\": \"InstrumentationTest.traced\""), std::string::npos);
+    ASSERT_NE(trace.find("\"ph\": \"X\""), std::string::npos);
+}
+
+TEST(InstrumentationTest, FullRingDropsInsteadOfBlocking) {
+    Instrumentation::reset();
+
+    for (int i = 0; i < 100000; ++i) {
+        Instrumentation::counter("InstrumentationTest.flood", i);
+    }
+
+    ASSERT_GT(Instrumentation::droppedEvents(), 0u);
+    Instrumentation::reset();
+    ASSERT_EQ(Instrumentation::droppedEvents(), 0u);
+}
+
+TEST(InstrumentationTest, ExitedThreadsHandOverDrainedBuffers) {
+    const std::string tracePath = "test_instrumentation_trace.json";
+    Instrumentation::reset();
+
+    for (int i = 0; i < 32; ++i) {
+        std::thread worker([]() { QPO_COUNTER("InstrumentationTest.shortLived", 1); });
+        worker.join();
+        Instrumentation::flush();
+    }
+    ASSERT_TRUE(Instrumentation::exportChromeTrace(tracePath));
+
+    // Each event shows up once: a recycled buffer starts empty instead of replaying its previous owner
+    std::string trace = readFile(tracePath);
+    std::size_t count = 0;
+    for (std::size_t at = trace.find("InstrumentationTest.shortLived"); at != std::string::npos;
+         at = trace.find("InstrumentationTest.shortLived", at + 1)) {
+        ++count;
+    }
+    ASSERT_EQ(count, 32u);
+    std::remove(tracePath.c_str());
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include "../src/utils/MemoryArena.hpp"
+
+TEST(MemoryArenaTest, StateBufferReusesItsAllocation) {
+    StateBuffer<std::complex<double>> buffer;
+    auto before = HugePageAllocator::stats();
+    std::complex<double>* first = buffer.acquire(std::size_t(1) << 18); // 4 MB, mapped
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(first) % HugePageAllocator::alignment, 0u);
+    first[(std::size_t(1) << 18) - 1] = 1.0;
+
+    std::complex<double>* second = buffer.acquire(std::size_t(1) << 17);
+    std::complex<double>* third = buffer.acquire(std::size_t(1) << 18);
+    auto after = HugePageAllocator::stats();
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(first, third);
+    ASSERT_EQ(after.allocations - before.allocations, 1u);
+    ASSERT_GE(after.reuses - before.reuses, 2u);
+    ASSERT_GE(buffer.capacity(), std::size_t(1) << 18);
+#if defined(__linux__)
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(first) % HugePageAllocator::hugePageBytes, 0u);
+#endif
+}
+
+TEST(MemoryArenaTest, ResetMergesBlocksAndScopesRewind) {
+    MemoryArena arena(4096);
+    double* a = arena.allocate<double>(300);
+    double* b = arena.allocate<double>(300); // Does not fit the first block
+    ASSERT_NE(a, b);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(b) % HugePageAllocator::alignment, 0u);
+    const std::size_t capacity = arena.capacity();
+
+    arena.reset();
+    ASSERT_EQ(arena.bytesUsed(), 0u);
+    ASSERT_GE(arena.capacity(), capacity);
+
+    // After merging, the same round fits in one block without allocating
+    auto before = HugePageAllocator::stats();
+    arena.allocate<double>(300);
+    {
+        MemoryArena::Scope scope(arena);
+        arena.allocate<double>(300);
+        ASSERT_GT(arena.bytesUsed(), 600 * sizeof(double) - 1);
+    }
+    ASSERT_LT(arena.bytesUsed(), 600 * sizeof(double));
+    arena.allocate<double>(300);
+    ASSERT_EQ(HugePageAllocator::stats().allocations, before.allocations);
+}
+
+TEST(MemoryArenaTest, OversizedRequestsThrowInsteadOfWrapping) {
+    const std::size_t huge = std::numeric_limits<std::size_t>::max() / 4;
+    StateBuffer<std::complex<double>> buffer;
+    ASSERT_THROW(buffer.acquire(huge), std::length_error);
+    ASSERT_EQ(buffer.capacity(), 0u);
+
+    MemoryArena arena;
+    ASSERT_THROW(arena.allocate<double>(huge), std::length_error);
+    ASSERT_THROW(arena.allocate(std::numeric_limits<std::size_t>::max() - 8), std::bad_alloc);
+    ASSERT_THROW(HugePageAllocator::allocate(std::numeric_limits<std::size_t>::max()), std::bad_alloc);
+}
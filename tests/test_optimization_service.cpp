@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <ext/stdio_filebuf.h>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "../src/utils/OptimizationService.hpp"
+
+namespace {
+
+// Writes a returns CSV of a few correlated assets and returns its path
+std::string writeReturns(const char* path, int assets, int periods) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.02);
+    std::ofstream out(path);
+    for (int a = 0; a < assets; ++a) out << (a ? "," : "") << "Asset_" << a;
+    out << '\n';
+    for (int t = 0; t < periods; ++t) {
+        const double market = noise(rng);
+        for (int a = 0; a < assets; ++a) out << (a ? "," : "") << 0.001 * a + 0.5 * market + noise(rng);
+        out << '\n';
+    }
+    return path;
+}
+
+std::vector<std::string> lines(const std::string& text) {
+    std::vector<std::string> result;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) result.push_back(line);
+    return result;
+}
+
+} // namespace
+
+TEST(OptimizationServiceTest, AnswersBatchedRequestsInOrder) {
+    const std::string path = writeReturns("test_service_returns.csv", 8, 120);
+    std::istringstream in("load equities returns=" + path + "\n"
+                          "optimize a universe=equities solver=tabu budget=3\n"
+                          "optimize b universe=equities solver=sa budget=3\n"
+                          "optimize c universe=equities solver=riskparity\n"
+                          "optimize d universe=missing\n"
+                          "flush\n"
+                          "stats\n"
+                          "quit\n");
+    std::ostringstream out;
+    OptimizationService service(2);
+    ASSERT_EQ(service.run(in, out), 0);
+    std::remove(path.c_str());
+
+    auto reply = lines(out.str());
+    ASSERT_EQ(reply.size(), 6u);
+    EXPECT_EQ(reply[0], "ok load equities assets=8 periods=120");
+    EXPECT_EQ(reply[1].rfind("result a solver=tabu energy=", 0), 0u);
+    EXPECT_EQ(reply[2].rfind("result b solver=sa energy=", 0), 0u);
+    EXPECT_EQ(reply[3].rfind("result c solver=riskparity return=", 0), 0u);
+    EXPECT_EQ(reply[4], "error d unknown universe 'missing'");
+    // Tabu and annealing share the cached QUBO and the same budget-constrained optimum
+    EXPECT_EQ(reply[1].substr(reply[1].find(" weights=")), reply[2].substr(reply[2].find(" weights=")));
+    EXPECT_EQ(reply[5], "ok stats universes=1 served=3 pending=0 qubos=1 factorizations=1");
+    EXPECT_EQ(service.pendingRequests(), 0u);
+}
+
+TEST(OptimizationServiceTest, KeepsStateAcrossFlushes) {
+    const std::string path = writeReturns("test_service_returns_warm.csv", 6, 80);
+    OptimizationService service(1);
+    std::ostringstream out;
+    ASSERT_TRUE(service.handleLine("load u returns=" + path, out));
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(service.handleLine("optimize first universe=u solver=ga budget=2 seed=3", out));
+    ASSERT_EQ(service.pendingRequests(), 1u);
+    service.flush(out);
+    ASSERT_TRUE(service.handleLine("optimize second universe=u solver=tabu budget=2", out));
+    ASSERT_TRUE(service.handleLine("optimize third universe=u solver=tabu budget=4", out));
+    service.flush(out);
+    ASSERT_TRUE(service.handleLine("stats", out));
+    ASSERT_TRUE(service.handleLine("optimize x universe=u solver=unknown", out));
+    service.flush(out);
+    ASSERT_FALSE(service.handleLine("quit", out));
+
+    auto reply = lines(out.str());
+    ASSERT_EQ(reply.size(), 6u);
+    EXPECT_EQ(reply[1].rfind("result first ", 0), 0u);
+    EXPECT_EQ(reply[2].rfind("result second ", 0), 0u);
+    EXPECT_EQ(reply[3].rfind("result third ", 0), 0u);
+    EXPECT_EQ(reply[4], "ok stats universes=1 served=3 pending=0 qubos=2 factorizations=1");
+    EXPECT_EQ(reply[5].rfind("error x unknown solver", 0), 0u);
+}
+
+TEST(OptimizationServiceTest, ErrorsKeepTheirPlaceInRequestOrder) {
+    const std::string path = writeReturns("test_service_returns_errors.csv", 6, 80);
+    OptimizationService service(2);
+    std::ostringstream out;
+    ASSERT_TRUE(service.handleLine("load u returns=" + path, out));
+    std::remove(path.c_str());
+
+    ASSERT_TRUE(service.handleLine("optimize a universe=u budget=2", out));
+    ASSERT_TRUE(service.handleLine("optimize b universe=u seed=abc", out));
+    ASSERT_TRUE(service.handleLine("optimize c universe=u budget=-1", out));
+    ASSERT_TRUE(service.handleLine("optimize d universe=u riskAversion=2x", out));
+    ASSERT_TRUE(service.handleLine("optimize e universe=u budget=3", out));
+    EXPECT_EQ(service.pendingRequests(), 5u);
+    ASSERT_TRUE(service.handleLine("bogus", out));  // Answers the queued requests first
+    EXPECT_EQ(service.pendingRequests(), 0u);
+
+    auto reply = lines(out.str());
+    ASSERT_EQ(reply.size(), 7u);
+    EXPECT_EQ(reply[1].rfind("result a ", 0), 0u);
+    EXPECT_EQ(reply[2], "error b bad seed 'abc'");
+    EXPECT_EQ(reply[3], "error c bad budget '-1'");
+    EXPECT_EQ(reply[4], "error d bad riskAversion '2x'");
+    EXPECT_EQ(reply[5].rfind("result e ", 0), 0u);
+    EXPECT_EQ(reply[6], "error bogus unknown command");
+}
+
+TEST(OptimizationServiceTest, BatchesRequestsArrivingThroughAPipe) {
+    const std::string path = writeReturns("test_service_returns_pipe.csv", 6, 80);
+    std::string script = "load u returns=" + path + "\n";
+    for (int r = 0; r < 6; ++r) {
+        script += "optimize r" + std::to_string(r) + " universe=u solver=tabu budget=" + std::to_string(1 + r % 3) + "\n";
+    }
+    script += "quit\n";
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], script.data(), script.size()), static_cast<ssize_t>(script.size()));
+    close(fds[1]);
+    __gnu_cxx::stdio_filebuf<char> buffer(fds[0], std::ios::in);
+    std::istream in(&buffer);
+
+    OptimizationService service(2);
+    std::ostringstream out;
+    ASSERT_EQ(service.run(in, out), 0);
+    std::remove(path.c_str());
+
+    auto reply = lines(out.str());
+    ASSERT_EQ(reply.size(), 7u);
+    for (int r = 0; r < 6; ++r) {
+        EXPECT_EQ(reply[1 + r].rfind("result r" + std::to_string(r) + " ", 0), 0u);
+    }
+    EXPECT_EQ(service.flushedBatches(), 1u);  // Everything was waiting in the pipe, so one batch answers it all
+}
+
+TEST(OptimizationServiceTest, KeepsOnlyRecentQUBOsCached) {
+    const std::string path = writeReturns("test_service_returns_lru.csv", 5, 60);
+    OptimizationService service(2);
+    std::ostringstream out;
+    ASSERT_TRUE(service.handleLine("load u returns=" + path, out));
+    std::remove(path.c_str());
+
+    for (int r = 0; r < 40; ++r) {
+        ASSERT_TRUE(service.handleLine("optimize r" + std::to_string(r) + " universe=u solver=sa budget=2 penalty=" +
+                                           std::to_string(1 + r),
+                                       out));
+    }
+    service.flush(out);
+    ASSERT_TRUE(service.handleLine("stats", out));
+
+    auto reply = lines(out.str());
+    ASSERT_EQ(reply.size(), 42u);
+    for (int r = 0; r < 40; ++r) {
+        EXPECT_EQ(reply[1 + r].rfind("result r" + std::to_string(r) + " ", 0), 0u);
+    }
+    EXPECT_EQ(reply[41], "ok stats universes=1 served=40 pending=0 qubos=16 factorizations=1");
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/utils/PerformanceEvaluator.hpp"
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+boost::numeric::ublas::matrix<double> makeQUBO(int size) {
+    boost::numeric::ublas::matrix<double> QUBO_matrix(size, size);
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            QUBO_matrix(i, j) = (i == j) ? -1.0 - 0.1 * i : 0.3 * ((i + j) % 3) - 0.2;
+        }
+    }
+    return QUBO_matrix;
+}
+
+} // namespace
+
+TEST(PerformanceEvaluatorTest, BruteForceMatchesExhaustiveSearch) {
+    auto QUBO_matrix = makeQUBO(10);
+
+    double expected = 0.0;
+    for (int mask = 0; mask < (1 << 10); ++mask) {
+        std::vector<int> state(10);
+        for (int k = 0; k < 10; ++k) state[k] = (mask >> k) & 1;
+        expected = std::min(expected, PerformanceEvaluator::computeEnergy(state, QUBO_matrix));
+    }
+
+    std::vector<int> argmin;
+    double minimum = PerformanceEvaluator::bruteForceMinimum(QUBO_matrix, &argmin, 3);
+
+    ASSERT_NEAR(minimum, expected, 1e-9);
+    ASSERT_NEAR(PerformanceEvaluator::computeEnergy(argmin, QUBO_matrix), expected, 1e-9);
+}
+
+TEST(PerformanceEvaluatorTest, TimeToSolution) {
+    ASSERT_DOUBLE_EQ(PerformanceEvaluator::timeToSolution(2.0, 1.0), 2.0);
+    ASSERT_TRUE(std::isinf(PerformanceEvaluator::timeToSolution(2.0, 0.0)));
+    ASSERT_NEAR(PerformanceEvaluator::timeToSolution(1.0, 0.5), std::log(0.01) / std::log(0.5), 1e-12);
+}
+
+TEST(PerformanceEvaluatorTest, SeededRunsAreReproducible) {
+    auto QUBO_matrix = makeQUBO(8);
+
+    PerformanceEvaluator first(QUBO_matrix, 16, 42, 2, false);
+    first.addSolver("simulated_annealing", PerformanceEvaluator::simulatedAnnealingSolver(5.0, 0.99, 2000));
+    PerformanceEvaluator second(QUBO_matrix, 16, 42, 4, false);
+    second.addSolver("simulated_annealing", PerformanceEvaluator::simulatedAnnealingSolver(5.0, 0.99, 2000));
+
+    auto a = first.run();
+    auto b = second.run();
+
+    ASSERT_EQ(a.size(), 1u);
+    ASSERT_EQ(a[0].hits, b[0].hits);
+    ASSERT_DOUBLE_EQ(a[0].meanEnergy, b[0].meanEnergy);
+    ASSERT_GE(a[0].bestEnergy, a[0].referenceEnergy - 1e-9);
+
+    std::ostringstream csv;
+    PerformanceEvaluator::writeCSV(a, csv);
+    ASSERT_NE(csv.str().find("simulated_annealing,16,"), std::string::npos);
+}
+
+#if defined(__linux__)
+TEST(PerformanceEvaluatorTest, PinningLeavesCallerAffinityAlone) {
+    cpu_set_t before;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+
+    PerformanceEvaluator evaluator(makeQUBO(6), 4, 7, 2, true);
+    evaluator.addSolver("simulated_annealing", PerformanceEvaluator::simulatedAnnealingSolver(5.0, 0.99, 500));
+    evaluator.run();
+
+    cpu_set_t after;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+    ASSERT_TRUE(CPU_EQUAL(&before, &after));
+}
+
+TEST(PerformanceEvaluatorTest, PinnedWorkersGetDisjointCpuSetsPerSolverThreads) {
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    const int threadsPerRun = std::max(1, CPU_COUNT(&allowed) / 2);
+
+    std::mutex mutex;
+    std::vector<cpu_set_t> masks;
+    auto solver = [&](const PerformanceEvaluator::QUBOMatrix& QUBO_matrix, unsigned int) {
+        cpu_set_t mask;
+        sched_getaffinity(0, sizeof(mask), &mask);
+        std::lock_guard<std::mutex> lock(mutex);
+        masks.push_back(mask);
+        return std::vector<int>(QUBO_matrix.size1(), 0);
+    };
+
+    PerformanceEvaluator evaluator(makeQUBO(4), 8, 3, 4, true);
+    evaluator.addSolver("probe", solver, threadsPerRun);
+    evaluator.run();
+
+    ASSERT_EQ(masks.size(), 8u);
+    for (cpu_set_t& mask : masks) {
+        ASSERT_EQ(CPU_COUNT(&mask), threadsPerRun);
+        cpu_set_t outside;
+        CPU_XOR(&outside, &mask, &allowed);
+        CPU_AND(&outside, &outside, &mask);
+        ASSERT_EQ(CPU_COUNT(&outside), 0);
+    }
+    ASSERT_THROW(evaluator.addSolver("bad", solver, 0), std::invalid_argument);
+}
+#endif
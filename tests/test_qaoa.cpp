@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <stdexcept>
 #include "../src/quantum_algorithms/QAOA.hpp"
+#include "../src/utils/Checkpoint.hpp"
 
 TEST(QAOATest, OptimizationResult) {
     int num_qubits = 4;
@@ -16,3 +19,71 @@ TEST(QAOATest, OptimizationResult) {
     // Validate the optimization result (example condition)
     ASSERT_TRUE(result >= 0.0);
 }
+
+TEST(QAOATest, RejectsMismatchedProblemInstance) {
+    QAOA qaoa(3, 1);
+    qaoa.setParameters({0.4}, {0.3});
+
+    // The state vector is kept between calls; a wrong-sized instance must not touch it
+    ASSERT_THROW(qaoa.optimize({0.1, 0.2}), std::invalid_argument);
+    ASSERT_GE(qaoa.optimize({0.1, 0.2, 0.3}), 0.0);
+    ASSERT_GE(qaoa.optimize({0.1, 0.2, 0.3}), 0.0);
+}
+
+TEST(QAOATest, RejectsCircuitsTooLargeToSimulate) {
+    const int num_qubits = QAOA::MAX_SIMULATED_QUBITS + 1;
+    QAOA qaoa(num_qubits, 1);
+    qaoa.setParameters({0.4}, {0.3});
+    ASSERT_THROW(qaoa.optimize(std::vector<double>(num_qubits, 0.1)), std::invalid_argument);
+}
+
+TEST(QAOATest, SweepResumesBitForBit) {
+    const char* path = "test_qaoa_sweep.ckpt";
+    std::remove(path);
+    std::vector<double> problem_instance = {0.4, -0.2, 0.7, -0.5, 0.3};
+    std::vector<std::vector<double>> gammas;
+    std::vector<std::vector<double>> betas;
+    for (int i = 0; i < 12; ++i) {
+        gammas.push_back({0.1 * i, 0.05 * i});
+        betas.push_back({0.7 - 0.05 * i, 0.3});
+    }
+
+    QAOA reference(5, 2);
+    reference.setSeed(9);
+    auto expected = reference.sweep(problem_instance, gammas, betas);
+
+    QAOA interrupted(5, 2);
+    interrupted.setSeed(9);
+    Checkpoint::requestStop();
+    ASSERT_THROW(interrupted.sweep(problem_instance, gammas, betas, path, 5), CheckpointInterrupted);
+    Checkpoint::clearStop();
+
+    QAOA resumed(5, 2); // A fresh process: the RNG state comes from the checkpoint
+    auto result = resumed.sweep(problem_instance, gammas, betas, path, 5);
+    std::remove(path);
+    ASSERT_EQ(result.objective, expected.objective);
+    ASSERT_EQ(result.gamma, expected.gamma);
+    ASSERT_EQ(result.beta, expected.beta);
+    ASSERT_EQ(result.solution, expected.solution);
+}
+
+TEST(QAOATest, SweepRanksSchedulesByExpectedCost) {
+    std::vector<double> problem_instance = {0.5, -1.0, 2.0};
+    QAOA qaoa(3, 1);
+
+    // Without any rotation the state stays uniform, so <C> is half the total weight
+    auto uniform = qaoa.sweep(problem_instance, {{0.0}}, {{0.0}});
+    ASSERT_NEAR(uniform.objective, 0.75, 1e-12);
+
+    std::vector<std::vector<double>> gammas;
+    std::vector<std::vector<double>> betas;
+    for (int i = 0; i <= 8; ++i) {
+        for (int j = 0; j <= 8; ++j) {
+            gammas.push_back({0.2 * i});
+            betas.push_back({0.1 * j});
+        }
+    }
+    auto best = qaoa.sweep(problem_instance, gammas, betas);
+    ASSERT_LT(best.objective, 0.75);
+    ASSERT_EQ(best.solution.size(), 3u);
+}
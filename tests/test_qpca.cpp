@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/quantum_algorithms/QPCA.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+namespace {
+
+// Covariance of three sectors: strong common factor within a sector plus idiosyncratic noise
+ublas::matrix<double> makeSectorCovariance(std::size_t perSector) {
+    const std::size_t n = 3 * perSector;
+    ublas::matrix<double> covariance(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const bool sameSector = i / perSector == j / perSector;
+            covariance(i, j) = (sameSector ? 0.04 * (1 + i / perSector) : 0.002) + (i == j ? 0.01 : 0.0);
+        }
+    }
+    return covariance;
+}
+
+double energy(const std::vector<int>& x, const ublas::matrix<double>& Q) {
+    double e = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+        for (size_t j = 0; j < x.size(); ++j) e += Q(i, j) * x[i] * x[j];
+    return e;
+}
+
+std::vector<int> bruteForce(const ublas::matrix<double>& Q) {
+    const int n = static_cast<int>(Q.size1());
+    std::vector<int> best(n, 0), x(n);
+    double bestEnergy = 0.0;
+    for (int mask = 0; mask < (1 << n); ++mask) {
+        for (int k = 0; k < n; ++k) x[k] = (mask >> k) & 1;
+        const double e = energy(x, Q);
+        if (e < bestEnergy) {
+            bestEnergy = e;
+            best = x;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+TEST(QPCATest, RandomizedEigenRecoversLeadingSpectrum) {
+    const std::size_t n = 60;
+    std::mt19937 gen(3);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    // Random orthogonal basis by Gram-Schmidt
+    std::vector<std::vector<double>> u(n, std::vector<double>(n));
+    for (auto& v : u) for (double& x : v) x = normal(gen);
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t p = 0; p < k; ++p) {
+            double dot = 0.0;
+            for (std::size_t i = 0; i < n; ++i) dot += u[k][i] * u[p][i];
+            for (std::size_t i = 0; i < n; ++i) u[k][i] -= dot * u[p][i];
+        }
+        double norm = 0.0;
+        for (double x : u[k]) norm += x * x;
+        for (double& x : u[k]) x /= std::sqrt(norm);
+    }
+    ublas::matrix<double> a = ublas::zero_matrix<double>(n, n);
+    for (std::size_t k = 0; k < n; ++k) {
+        const double lambda = std::pow(0.5, static_cast<double>(k));
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t j = 0; j < n; ++j) a(i, j) += lambda * u[k][i] * u[k][j];
+    }
+
+    QPCA::Settings settings;
+    settings.numThreads = 2;
+    auto decomposition = QPCA::randomizedEigen(a, 5, settings);
+    ASSERT_EQ(decomposition.eigenvalues.size(), 5u);
+    for (std::size_t k = 0; k < 5; ++k) {
+        ASSERT_NEAR(decomposition.eigenvalues[k], std::pow(0.5, static_cast<double>(k)), 1e-8);
+        double alignment = 0.0;
+        for (std::size_t i = 0; i < n; ++i) alignment += decomposition.eigenvectors(i, k) * u[k][i];
+        ASSERT_NEAR(std::fabs(alignment), 1.0, 1e-6);
+    }
+}
+
+TEST(QPCATest, ClustersSectorsAndPreservesEnergyOnLift) {
+    const std::size_t perSector = 8;
+    auto covariance = makeSectorCovariance(perSector);
+    const std::size_t n = covariance.size1();
+    ublas::matrix<double> Q = covariance;
+    for (std::size_t i = 0; i < n; ++i) Q(i, i) -= 0.05 * (1 + i % 3);
+
+    QPCA::Settings settings;
+    settings.components = 3;
+    settings.clusters = 3;
+    auto reduction = QPCA::reduce(Q, covariance, settings);
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(reduction.assignment[i], reduction.assignment[(i / perSector) * perSector]);
+    }
+    ASSERT_NE(reduction.assignment[0], reduction.assignment[perSector]);
+    ASSERT_NE(reduction.assignment[0], reduction.assignment[2 * perSector]);
+
+    for (int mask = 0; mask < 8; ++mask) {
+        std::vector<int> z = {mask & 1, (mask >> 1) & 1, (mask >> 2) & 1};
+        ASSERT_NEAR(energy(QPCA::lift(reduction, z), Q), energy(z, reduction.reducedQUBO), 1e-12);
+    }
+}
+
+TEST(QPCATest, SolvesReducedProblemAndRefinesLiftedSolution) {
+    auto covariance = makeSectorCovariance(5);
+    const std::size_t n = covariance.size1();
+    ublas::matrix<double> Q = covariance;
+    for (std::size_t i = 0; i < n; ++i) Q(i, i) -= 0.03 + 0.01 * (i % 4);
+
+    QPCA::Settings settings;
+    settings.components = 3;
+    settings.clusters = 6;
+    settings.refine = false;
+    auto coarse = QPCA::solve(Q, covariance, bruteForce, settings);
+    settings.refine = true;
+    auto refined = QPCA::solve(Q, covariance, bruteForce, settings);
+
+    ASSERT_EQ(coarse.reducedSolution.size(), 6u);
+    ASSERT_NEAR(coarse.energy, energy(coarse.solution, Q), 1e-12);
+    ASSERT_LE(refined.energy, coarse.energy + 1e-12);
+
+    settings.aggregation = QPCA::Aggregation::Representative;
+    auto representative = QPCA::solve(Q, covariance, bruteForce, settings);
+    ASSERT_EQ(representative.solution.size(), n);
+    ASSERT_NEAR(representative.energy, energy(representative.solution, Q), 1e-12);
+}
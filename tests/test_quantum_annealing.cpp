@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
 #include <boost/numeric/ublas/matrix.hpp>
 #include "../src/quantum_algorithms/QuantumAnnealing.hpp"
+#include "../src/utils/Checkpoint.hpp"
 
 TEST(QuantumAnnealingTest, SolveQUBO) {
     int num_qubits = 4;
@@ -22,3 +25,31 @@ TEST(QuantumAnnealingTest, SolveQUBO) {
         ASSERT_TRUE(bit == 0 || bit == 1);
     }
 }
+
+TEST(QuantumAnnealingTest, ResumesBitForBit) {
+    const char* path = "test_quantum_annealing.ckpt";
+    std::remove(path);
+    const int num_qubits = 16;
+    boost::numeric::ublas::matrix<double> QUBO_matrix(num_qubits, num_qubits);
+    for (int i = 0; i < num_qubits; ++i) {
+        for (int j = 0; j < num_qubits; ++j) {
+            QUBO_matrix(i, j) = std::sin(1.0 + i * 7 + j * 3);
+        }
+    }
+
+    QuantumAnnealing reference(num_qubits);
+    reference.setSeed(5);
+    std::vector<int> expected = reference.solveQUBO(QUBO_matrix);
+
+    QuantumAnnealing interrupted(num_qubits);
+    interrupted.setSeed(5);
+    interrupted.setCheckpoint(path, 60);
+    Checkpoint::requestStop();
+    ASSERT_THROW(interrupted.solveQUBO(QUBO_matrix), CheckpointInterrupted);
+    Checkpoint::clearStop();
+
+    QuantumAnnealing resumed(num_qubits);
+    resumed.setCheckpoint(path, 60);
+    ASSERT_EQ(resumed.solveQUBO(QUBO_matrix), expected);
+    std::remove(path);
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/utils/Checkpoint.hpp"
+#include "../src/utils/LinearAlgebra.hpp"
+#include "../src/utils/RiskCalculator.hpp"
+
+namespace {
+
+boost::numeric::ublas::matrix<double> makeCovariance() {
+    boost::numeric::ublas::matrix<double> covariance(3, 3);
+    const double values[3][3] = {{0.04, 0.006, 0.002}, {0.006, 0.09, 0.009}, {0.002, 0.009, 0.0625}};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            covariance(i, j) = values[i][j];
+        }
+    }
+    return covariance;
+}
+
+boost::numeric::ublas::matrix<double> makePortfolios() {
+    boost::numeric::ublas::matrix<double> portfolios(2, 3);
+    portfolios(0, 0) = 0.5; portfolios(0, 1) = 0.3; portfolios(0, 2) = 0.2;
+    portfolios(1, 0) = 1.0; portfolios(1, 1) = -0.5; portfolios(1, 2) = 0.5;
+    return portfolios;
+}
+
+} // namespace
+
+TEST(RiskCalculatorTest, CholeskyReproducesCovariance) {
+    auto covariance = makeCovariance();
+    std::vector<double> factor(covariance.data().begin(), covariance.data().end());
+    ASSERT_TRUE(LinearAlgebra::cholesky(factor.data(), 3));
+
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            double value = 0.0;
+            for (int p = 0; p < 3; ++p) value += factor[i * 3 + p] * factor[j * 3 + p];
+            ASSERT_NEAR(value, covariance(i, j), 1e-12);
+        }
+    }
+}
+
+TEST(RiskCalculatorTest, MonteCarloMatchesAnalyticGaussianRisk) {
+    RiskCalculator calculator({0.01, 0.02, 0.015}, makeCovariance());
+    auto portfolios = makePortfolios();
+
+    RiskCalculator::SimulationSettings settings;
+    settings.scenarios = 400000;
+    settings.numThreads = 2;
+    auto simulated = calculator.monteCarloRisk(portfolios, settings);
+    auto analytic = calculator.analyticRisk(portfolios, settings.confidence);
+
+    ASSERT_EQ(simulated.size(), 2u);
+    for (size_t p = 0; p < simulated.size(); ++p) {
+        ASSERT_NEAR(simulated[p].expectedPnL, analytic[p].expectedPnL, 2e-3);
+        ASSERT_NEAR(simulated[p].volatility, analytic[p].volatility, 0.01 * analytic[p].volatility);
+        ASSERT_NEAR(simulated[p].valueAtRisk, analytic[p].valueAtRisk, 0.02 * analytic[p].valueAtRisk);
+        ASSERT_NEAR(simulated[p].conditionalValueAtRisk, analytic[p].conditionalValueAtRisk, 0.02 * analytic[p].conditionalValueAtRisk);
+        ASSERT_GT(simulated[p].conditionalValueAtRisk, simulated[p].valueAtRisk);
+    }
+}
+
+TEST(RiskCalculatorTest, ResultDoesNotDependOnThreadCount) {
+    RiskCalculator calculator({0.01, 0.02, 0.015}, makeCovariance());
+    auto portfolios = makePortfolios();
+
+    RiskCalculator::SimulationSettings settings;
+    settings.scenarios = 50000;
+    settings.blockSize = 777;
+    settings.numThreads = 1;
+    auto serial = calculator.monteCarloRisk(portfolios, settings);
+    settings.numThreads = 3;
+    auto threaded = calculator.monteCarloRisk(portfolios, settings);
+
+    for (size_t p = 0; p < serial.size(); ++p) {
+        ASSERT_DOUBLE_EQ(serial[p].valueAtRisk, threaded[p].valueAtRisk);
+        ASSERT_NEAR(serial[p].conditionalValueAtRisk, threaded[p].conditionalValueAtRisk, 1e-12);
+    }
+}
+
+TEST(RiskCalculatorTest, QuasiRandomAndAntitheticModesMatchAnalyticRisk) {
+    RiskCalculator calculator({0.01, 0.02, 0.015}, makeCovariance());
+    auto portfolios = makePortfolios();
+    auto analytic = calculator.analyticRisk(portfolios, 0.99);
+
+    RiskCalculator::SimulationSettings settings;
+    settings.scenarios = 1 << 16;
+    settings.numThreads = 2;
+    settings.sampling = RiskCalculator::SamplingMethod::ScrambledSobol;
+    settings.horizonSteps = 4;
+    settings.antithetic = true;
+    for (auto construction : {RiskCalculator::PathConstruction::BrownianBridge, RiskCalculator::PathConstruction::Incremental}) {
+        settings.pathConstruction = construction;
+        auto simulated = calculator.monteCarloRisk(portfolios, settings);
+        for (size_t p = 0; p < simulated.size(); ++p) {
+            ASSERT_NEAR(simulated[p].expectedPnL, analytic[p].expectedPnL, 1e-9);  // Exact under antithetic pairs
+            ASSERT_NEAR(simulated[p].volatility, analytic[p].volatility, 0.01 * analytic[p].volatility);
+            ASSERT_NEAR(simulated[p].valueAtRisk, analytic[p].valueAtRisk, 0.02 * analytic[p].valueAtRisk);
+            ASSERT_NEAR(simulated[p].conditionalValueAtRisk, analytic[p].conditionalValueAtRisk, 0.02 * analytic[p].conditionalValueAtRisk);
+        }
+    }
+}
+
+TEST(RiskCalculatorTest, ReplicationsReportStandardErrors) {
+    RiskCalculator calculator({0.01, 0.02, 0.015}, makeCovariance());
+    auto portfolios = makePortfolios();
+    auto analytic = calculator.analyticRisk(portfolios, 0.99);
+
+    RiskCalculator::SimulationSettings settings;
+    settings.scenarios = 200000;
+    settings.replications = 8;
+    settings.numThreads = 2;
+    settings.controlVariate = true;
+    auto simulated = calculator.monteCarloRisk(portfolios, settings);
+
+    for (size_t p = 0; p < simulated.size(); ++p) {
+        ASSERT_GT(simulated[p].valueAtRiskStandardError, 0.0);
+        ASSERT_GT(simulated[p].conditionalValueAtRiskStandardError, 0.0);
+        ASSERT_NEAR(simulated[p].conditionalValueAtRisk, analytic[p].conditionalValueAtRisk,
+                    5.0 * simulated[p].conditionalValueAtRiskStandardError + 1e-3 * analytic[p].conditionalValueAtRisk);
+    }
+
+    settings.replications = 2;
+    ASSERT_THROW(calculator.monteCarloRisk(portfolios, settings), std::invalid_argument);
+
+    // Scenarios must split evenly, with at least one per replication
+    settings.controlVariate = false;
+    settings.scenarios = 200001;
+    ASSERT_THROW(calculator.monteCarloRisk(portfolios, settings), std::invalid_argument);
+    settings.scenarios = 4;
+    settings.replications = 8;
+    ASSERT_THROW(calculator.monteCarloRisk(portfolios, settings), std::invalid_argument);
+}
+
+TEST(RiskCalculatorTest, ConvergenceReportHasOneRowPerScenarioCount) {
+    RiskCalculator calculator({0.01, 0.02, 0.015}, makeCovariance());
+    auto portfolios = makePortfolios();
+
+    RiskCalculator::SimulationSettings settings;
+    settings.sampling = RiskCalculator::SamplingMethod::Sobol;
+    settings.replications = 4;
+    auto report = calculator.convergenceReport(portfolios, settings, {4096, 8192, 16384});
+    ASSERT_EQ(report.size(), 3u);
+    ASSERT_EQ(report[2].scenarios, 16384u);
+    ASSERT_EQ(report[2].metrics.size(), 2u);
+
+    std::ostringstream csv;
+    RiskCalculator::writeConvergenceCSV(report, csv);
+    size_t lines = 0;
+    for (char c : csv.str()) lines += c == '\n';
+    ASSERT_EQ(lines, 1u + 3u * 2u);
+}
+
+TEST(RiskCalculatorTest, CheckpointedRunResumesBitForBit) {
+    const char* path = "test_risk_calculator.ckpt";
+    std::remove(path);
+    RiskCalculator calculator({0.01, 0.02, 0.015}, makeCovariance());
+    auto portfolios = makePortfolios();
+
+    RiskCalculator::SimulationSettings settings;
+    settings.scenarios = 60000;
+    settings.blockSize = 1000;
+    settings.replications = 3;
+    settings.controlVariate = true;
+    settings.numThreads = 3;
+    auto reference = calculator.monteCarloRisk(portfolios, settings);
+
+    // Stop inside the first replication, resume with other threads and another checkpoint interval
+    settings.checkpointPath = path;
+    settings.checkpointBlocks = 7;
+    settings.numThreads = 2;
+    Checkpoint::requestStop();
+    ASSERT_THROW(calculator.monteCarloRisk(portfolios, settings), CheckpointInterrupted);
+    Checkpoint::clearStop();
+    settings.numThreads = 1;
+    settings.checkpointBlocks = 4;
+    auto resumed = calculator.monteCarloRisk(portfolios, settings);
+    std::remove(path);
+
+    ASSERT_EQ(resumed.size(), reference.size());
+    for (size_t p = 0; p < reference.size(); ++p) {
+        ASSERT_EQ(resumed[p].expectedPnL, reference[p].expectedPnL);
+        ASSERT_EQ(resumed[p].volatility, reference[p].volatility);
+        ASSERT_EQ(resumed[p].valueAtRisk, reference[p].valueAtRisk);
+        ASSERT_EQ(resumed[p].conditionalValueAtRisk, reference[p].conditionalValueAtRisk);
+        ASSERT_EQ(resumed[p].conditionalValueAtRiskStandardError, reference[p].conditionalValueAtRiskStandardError);
+    }
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/classical_algorithms/RiskParity.hpp"
+
+namespace {
+
+boost::numeric::ublas::matrix<double> makeCovariance() {
+    boost::numeric::ublas::matrix<double> covariance(4, 4);
+    const double values[4][4] = {{0.04, 0.006, 0.002, 0.001},
+                                 {0.006, 0.09, 0.009, 0.003},
+                                 {0.002, 0.009, 0.0625, 0.004},
+                                 {0.001, 0.003, 0.004, 0.01}};
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j) covariance(i, j) = values[i][j];
+    return covariance;
+}
+
+} // namespace
+
+TEST(RiskParityTest, EqualRiskContributions) {
+    FactorizationCache cache;
+    cache.setCovariance(makeCovariance());
+    RiskParity solver(cache);
+    auto result = solver.solve({});
+
+    ASSERT_TRUE(result.converged);
+    double total = 0.0;
+    for (size_t i = 0; i < 4; ++i) {
+        total += result.weights[i];
+        ASSERT_GT(result.weights[i], 0.0);
+        ASSERT_NEAR(result.riskContributions[i], 0.25, 1e-8);
+    }
+    ASSERT_NEAR(total, 1.0, 1e-12);
+    ASSERT_EQ(cache.factorizations(), 0u);  // Risk parity needs no factorization
+}
+
+TEST(RiskParityTest, BudgetsAndWarmStart) {
+    FactorizationCache cache;
+    cache.setCovariance(makeCovariance());
+    RiskParity solver(cache);
+    auto cold = solver.solve({0.4, 0.3, 0.2, 0.1});
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_NEAR(cold.riskContributions[i], 0.4 - 0.1 * i, 1e-8);
+    }
+
+    // A slightly different budget starts from the previous solution and needs fewer sweeps
+    RiskParity fresh(cache);
+    auto coldAgain = fresh.solve({0.39, 0.31, 0.2, 0.1});
+    auto warm = solver.solve({0.39, 0.31, 0.2, 0.1});
+    ASSERT_LT(warm.sweeps, coldAgain.sweeps);
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_NEAR(warm.weights[i], coldAgain.weights[i], 1e-8);
+    }
+
+    ASSERT_THROW(solver.solve({1.0, 1.0}), std::invalid_argument);
+    ASSERT_THROW(solver.solve({1.0, 0.0, 1.0, 1.0}), std::invalid_argument);
+}
+
+TEST(RiskParityTest, SharedCacheSurvivesConcurrentUpdates) {
+    // Readers solve against the cache while a writer swaps between 2 I and 4 I; every answer must
+    // come from one of the two matrices, never from a mix
+    const std::size_t n = 16;
+    boost::numeric::ublas::matrix<double> two(n, n, 0.0);
+    boost::numeric::ublas::matrix<double> four(n, n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        two(i, i) = 2.0;
+        four(i, i) = 4.0;
+    }
+    FactorizationCache cache(1);
+    cache.setCovariance(two);
+
+    std::atomic<bool> torn(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&]() {
+            for (int k = 0; k < 500; ++k) {
+                std::vector<double> x(n, 1.0);
+                cache.solve(x.data());
+                for (double value : x) {
+                    if (value != x[0] || (std::abs(value - 0.5) > 1e-12 && std::abs(value - 0.25) > 1e-12)) torn = true;
+                }
+                const std::vector<double> sigma = cache.covariance();
+                if (sigma.size() != n * n || (sigma[0] != 2.0 && sigma[0] != 4.0)) torn = true;
+            }
+        });
+    }
+    for (int k = 0; k < 500; ++k) {
+        cache.setCovariance(k % 2 ? two : four);
+    }
+    for (std::thread& reader : readers) reader.join();
+    ASSERT_FALSE(torn.load());
+}
+
+TEST(RiskParityTest, SnapshotKeepsDimensionCovarianceAndFactorTogether) {
+    // The writer also changes the dimension, so mixing two versions would index out of bounds
+    boost::numeric::ublas::matrix<double> small(4, 4, 0.0);
+    boost::numeric::ublas::matrix<double> large(8, 8, 0.0);
+    for (std::size_t i = 0; i < 4; ++i) small(i, i) = 2.0;
+    for (std::size_t i = 0; i < 8; ++i) large(i, i) = 4.0;
+    FactorizationCache cache(1);
+    cache.setCovariance(small);
+
+    std::atomic<bool> torn(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&]() {
+            RiskParity solver(cache);
+            for (int k = 0; k < 300; ++k) {
+                const auto state = cache.snapshot(true);
+                const std::size_t n = state->dimension;
+                if (state->covariance.size() != n * n || state->factor.size() != n * n ||
+                    state->covariance[0] != (n == 4 ? 2.0 : 4.0) ||
+                    std::abs(state->factor[0] * state->factor[0] - state->covariance[0]) > 1e-12) {
+                    torn = true;
+                }
+                const RiskParity::Result result = solver.solve({});
+                for (double weight : result.weights) {
+                    if (std::abs(weight - 1.0 / result.weights.size()) > 1e-9) torn = true;
+                }
+            }
+        });
+    }
+    for (int k = 0; k < 300; ++k) {
+        cache.setCovariance(k % 2 ? small : large);
+    }
+    for (std::thread& reader : readers) reader.join();
+    ASSERT_FALSE(torn.load());
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <boost/numeric/ublas/matrix.hpp>
+#include "../src/classical_algorithms/TabuSearch.hpp"
+
+namespace {
+
+boost::numeric::ublas::matrix<double> makeRandomQUBO(int size, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    boost::numeric::ublas::matrix<double> QUBO_matrix(size, size);
+    for (int i = 0; i < size; ++i) {
+        for (int j = 0; j < size; ++j) {
+            QUBO_matrix(i, j) = dist(gen);  // Deliberately asymmetric
+        }
+    }
+    return QUBO_matrix;
+}
+
+double energy(const std::vector<int>& x, const boost::numeric::ublas::matrix<double>& Q) {
+    double e = 0.0;
+    for (size_t i = 0; i < x.size(); ++i)
+        for (size_t j = 0; j < x.size(); ++j) e += Q(i, j) * x[i] * x[j];
+    return e;
+}
+
+double exhaustiveMinimum(const boost::numeric::ublas::matrix<double>& Q) {
+    const int n = static_cast<int>(Q.size1());
+    double best = 0.0;
+    std::vector<int> x(n);
+    for (int mask = 0; mask < (1 << n); ++mask) {
+        for (int k = 0; k < n; ++k) x[k] = (mask >> k) & 1;
+        best = std::min(best, energy(x, Q));
+    }
+    return best;
+}
+
+} // namespace
+
+TEST(TabuSearchTest, FindsExhaustiveOptimum) {
+    for (unsigned int seed = 1; seed <= 3; ++seed) {
+        auto Q = makeRandomQUBO(14, seed);
+        TabuSearch::Settings settings;
+        settings.restarts = 8;
+        settings.maxIterations = 2000;
+        settings.numThreads = 2;
+        settings.seed = seed;
+        auto result = TabuSearch::solve(Q, settings);
+
+        ASSERT_EQ(result.solution.size(), 14u);
+        ASSERT_NEAR(result.energy, energy(result.solution, Q), 1e-9);  // Incremental energy stays exact
+        ASSERT_NEAR(result.energy, exhaustiveMinimum(Q), 1e-9);
+        ASSERT_EQ(result.searches, 8);
+        ASSERT_FALSE(result.eliteEnergies.empty());
+        ASSERT_DOUBLE_EQ(result.eliteEnergies.front(), result.energy);
+    }
+}
+
+TEST(TabuSearchTest, StopsOnceTargetIsReached) {
+    auto Q = makeRandomQUBO(40, 9);
+    TabuSearch::Settings settings;
+    settings.restarts = 200;
+    settings.numThreads = 1;
+    settings.targetEnergy = 0.0;  // Any assignment with a negative diagonal entry beats this
+    auto result = TabuSearch::solve(Q, settings);
+
+    ASSERT_LE(result.energy, 0.0);
+    ASSERT_LT(result.searches, 200);
+}
+
+TEST(TabuSearchTest, SeedReproducesRunForAnyThreadCount) {
+    auto Q = makeRandomQUBO(30, 5);
+    TabuSearch::Settings settings;
+    settings.restarts = 40;
+    settings.maxIterations = 1500;
+    settings.waveSize = 8;
+    settings.seed = 11;
+    settings.numThreads = 1;
+    auto serial = TabuSearch::solve(Q, settings);
+    settings.numThreads = 4;
+    auto parallel = TabuSearch::solve(Q, settings);
+
+    ASSERT_EQ(serial.solution, parallel.solution);
+    ASSERT_EQ(serial.moves, parallel.moves);
+    ASSERT_EQ(serial.eliteEnergies, parallel.eliteEnergies);
+}
+
+TEST(TabuSearchTest, RejectsNonSquareMatrix) {
+    boost::numeric::ublas::matrix<double> Q(3, 4, 0.0);
+    ASSERT_THROW(TabuSearch::solve(Q, TabuSearch::Settings()), std::invalid_argument);
+}
+
+TEST(TabuSearchTest, RejectsNegativeWaveSize) {
+    TabuSearch::Settings settings;
+    settings.waveSize = -1;
+    ASSERT_THROW(TabuSearch::solve(makeRandomQUBO(6, 1), settings), std::invalid_argument);
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include "../src/utils/Parallel.hpp"
+#include "../src/utils/WorkStealingPool.hpp"
+
+TEST(WorkStealingPoolTest, RunsNestedTasks) {
+    std::atomic<int> count(0);
+    WorkStealingPool pool(4);
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&pool, &count]() {
+            count.fetch_add(1);
+            ASSERT_GE(WorkStealingPool::currentWorker(), 0);
+            pool.submit([&count]() { count.fetch_add(1); });  // Lands on the submitting worker's own deque
+        });
+    }
+    pool.wait();
+    ASSERT_EQ(count.load(), 200);
+    ASSERT_EQ(WorkStealingPool::currentWorker(), -1);
+}
+
+TEST(WorkStealingPoolTest, RethrowsTaskExceptions) {
+    WorkStealingPool pool(2);
+    pool.submit([]() { throw std::runtime_error("task failed"); });
+    pool.submit([]() {});
+    ASSERT_THROW(pool.wait(), std::runtime_error);
+    pool.submit([]() {});
+    ASSERT_NO_THROW(pool.wait());
+}
+
+TEST(ParallelTest, ForRangeJoinsAndRethrowsChunkExceptions) {
+    for (int failing = 0; failing < 4; ++failing) {
+        std::atomic<int> finished(0);
+        auto run = [&]() {
+            Parallel::forRange(0, 400, 4, [&](std::size_t, std::size_t, int thread) {
+                if (thread == failing) {
+                    throw std::runtime_error("chunk failed");
+                }
+                finished.fetch_add(1);
+            });
+        };
+        ASSERT_THROW(run(), std::runtime_error);
+        ASSERT_EQ(finished.load(), 3);  // Every other chunk ran to completion before the rethrow
+    }
+}